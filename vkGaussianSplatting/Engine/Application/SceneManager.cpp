@@ -2,10 +2,13 @@
 #include "SceneManager.h"
 #include "Scene.h"
 #include "../Graphics/Renderer.h"
+#include "../ResourceManager.h"
 
 SceneManager::SceneManager()
 	: currentScene(nullptr),
 	nextScene(nullptr),
+	loadingScene(nullptr),
+	loadingProgress(0.0f),
 	window(nullptr),
 	renderer(nullptr),
 	resourceManager(nullptr)
@@ -38,11 +41,16 @@ void SceneManager::setScene(Scene* newScene)
 
 void SceneManager::update()
 {
-	this->currentScene->update();
+	if (this->currentScene != nullptr)
+		this->currentScene->update();
 }
 
 void SceneManager::cleanup()
 {
+	this->waitForLoadingScene();
+	delete this->loadingScene;
+	this->loadingScene = nullptr;
+
 	delete this->nextScene;
 	this->nextScene = nullptr;
 
@@ -50,21 +58,60 @@ void SceneManager::cleanup()
 	this->currentScene = nullptr;
 }
 
+void SceneManager::waitForLoadingScene()
+{
+	if (this->loadingTask.valid())
+		this->loadingTask.get();
+}
+
 void SceneManager::updateToNextScene()
 {
-	// Scene should be switched
-	if (this->nextScene != nullptr)
+	const bool loadingTaskDone = this->loadingTask.valid() && 
+		this->loadingTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+	// The loading scene is done, or has its first gaussians resident when 
+	// loading progressively, so switch to it before this frame is rendered
+	if (this->loadingScene != nullptr && 
+		(loadingTaskDone || 
+			(this->resourceManager->getUseProgressiveLoading() && this->loadingProgress > 0.0f)))
 	{
 		// Switch
 		delete this->currentScene;
-		this->currentScene = this->nextScene;
-		this->nextScene = nullptr;
-
-		// Init new scene
-		this->currentScene->setSceneManager(*this);
-		this->currentScene->init();
+		this->currentScene = this->loadingScene;
+		this->loadingScene = nullptr;
 
 		// Init subsystems for the new scene
 		this->renderer->initForScene(*this->currentScene);
 	}
+
+	// The rest of the gaussians have been uploaded
+	if (loadingTaskDone)
+		this->waitForLoadingScene();
+
+	// Scene should be switched, so start loading it once the 
+	// current scene has been entirely uploaded
+	if (this->nextScene != nullptr && 
+		!this->loadingTask.valid() && 
+		this->renderer->isSceneFullyResident())
+	{
+		this->loadingScene = this->nextScene;
+		this->nextScene = nullptr;
+		this->loadingProgress = 0.0f;
+
+		Scene* scene = this->loadingScene;
+		scene->setSceneManager(*this);
+		this->loadingTask = std::async(
+			std::launch::async,
+			[this, scene]()
+			{
+				// Init new scene
+				scene->init();
+
+				// Upload gaussians of the new scene
+				this->renderer->loadGaussiansForScene(
+					[this](float progress) { this->loadingProgress = progress; }
+				);
+			}
+		);
+	}
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <future>
+
 class Engine;
 class Window;
 class Renderer;
@@ -18,7 +21,13 @@ private:
 	Scene* currentScene;
 	Scene* nextScene;
 
+	// Scenes are loaded on a background task, while the current scene keeps rendering
+	Scene* loadingScene;
+	std::future<void> loadingTask;
+	std::atomic<float> loadingProgress;
+
 	void updateToNextScene();
+	void waitForLoadingScene();
 
 public:
 	SceneManager();
@@ -34,4 +43,10 @@ public:
 	inline Renderer& getRenderer() const { return *this->renderer; }
 	inline ResourceManager& getResourceManager() const { return *this->resourceManager; }
 	inline Scene& getCurrentScene() const { return *this->currentScene; }
+	inline bool hasCurrentScene() const { return this->currentScene != nullptr; }
+	inline bool isLoadingScene() const { return this->loadingTask.valid(); }
+
+	// Fraction of the loading scene's gaussians that have been uploaded. 
+	// When loading progressively, the scene is switched to before this reaches 1.
+	inline float getLoadingProgress() const { return this->loadingProgress; }
 };
\ No newline at end of file
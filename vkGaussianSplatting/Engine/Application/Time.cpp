@@ -9,8 +9,8 @@ std::chrono::system_clock::time_point Time::lastTime = std::chrono::system_clock
 std::chrono::system_clock::time_point Time::currentTime = std::chrono::system_clock::time_point();
 std::chrono::duration<float> Time::elapsedSeconds = std::chrono::duration<float>();
 
-std::chrono::system_clock::time_point Time::userLastTime = std::chrono::system_clock::time_point();
-std::chrono::duration<float> Time::userElapsedSeconds = std::chrono::duration<float>();
+thread_local std::chrono::system_clock::time_point Time::userLastTime = std::chrono::system_clock::time_point();
+thread_local std::chrono::duration<float> Time::userElapsedSeconds = std::chrono::duration<float>();
 std::chrono::system_clock::time_point Time::godUserLastTime = std::chrono::system_clock::time_point();
 std::chrono::duration<float> Time::godUserElapsedSeconds = std::chrono::duration<float>();
 float Time::godUserTime = 0.0f;
@@ -15,8 +15,9 @@ private:
 	static std::chrono::system_clock::time_point currentTime;
 	static std::chrono::duration<float> elapsedSeconds;
 
-	static std::chrono::system_clock::time_point userLastTime;
-	static std::chrono::duration<float> userElapsedSeconds;
+	// Per thread, so scenes can be timed while loading in the background
+	static thread_local std::chrono::system_clock::time_point userLastTime;
+	static thread_local std::chrono::duration<float> userElapsedSeconds;
 	static std::chrono::system_clock::time_point godUserLastTime;
 	static std::chrono::duration<float> godUserElapsedSeconds;
 	static float godUserTime;
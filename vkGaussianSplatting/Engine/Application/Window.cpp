@@ -73,6 +73,11 @@ void Window::awaitEvents() const
 	glfwWaitEvents();
 }
 
+void Window::setTitle(const std::string& title)
+{
+	glfwSetWindowTitle(this->windowHandle, title.c_str());
+}
+
 void Window::getFramebufferSize(int& widthOutput, int& heightOutput) const
 {
 	glfwGetFramebufferSize(this->windowHandle, &widthOutput, &heightOutput);
@@ -18,6 +18,7 @@ public:
 	void init(Renderer& renderer, const std::string& title, int width, int height);
 	void update();
 	void awaitEvents() const;
+	void setTitle(const std::string& title);
 
 	void getFramebufferSize(int& widthOutput, int& heightOutput) const;
 	void getInstanceExtensions(const char**& extensions, uint32_t& extensionCount);
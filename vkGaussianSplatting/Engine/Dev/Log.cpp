@@ -4,8 +4,16 @@
 
 #include "Log.h"
 
+bool Log::usePopups = true;
+
 void Log::popupWindow(const std::string& title, const std::string& message)
 {
+	if (!Log::usePopups)
+	{
+		std::cout << "[Log " << title << "]: " << message << std::endl;
+		return;
+	}
+
 	// Convert const char* to LPCWSTR
 	wchar_t* wString = new wchar_t[4096];
 	MultiByteToWideChar(CP_ACP, 0, message.c_str(), -1, wString, 4096);
@@ -5,9 +5,14 @@
 class Log
 {
 private:
+	static bool usePopups;
+
 	static void popupWindow(const std::string& title, const std::string& message);
 
 public:
+	// Errors and alerts are written to the console instead, if disabled
+	static inline void setUsePopups(bool usePopups) { Log::usePopups = usePopups; }
+
 	static void write(const std::string& message);
 	static void writeAlert(const std::string& message);
 	static void warning(const std::string& message);
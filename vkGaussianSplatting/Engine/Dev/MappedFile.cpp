@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include <Windows.h>
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile()
+	: fileHandle(INVALID_HANDLE_VALUE),
+	mappingHandle(nullptr),
+	data(nullptr),
+	size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	this->unmap();
+}
+
+bool MappedFile::map(const std::string& filePath)
+{
+	this->unmap();
+
+	// Open file (the OS is hinted that the file is mostly read front to back)
+	this->fileHandle = CreateFileA(
+		filePath.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr
+	);
+	if (this->fileHandle == INVALID_HANDLE_VALUE)
+	{
+		Log::error("Failed to open file for mapping: " + filePath);
+		return false;
+	}
+
+	// File size
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(this->fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Log::error("Failed to get size of file, or file is empty: " + filePath);
+		this->unmap();
+		return false;
+	}
+	this->size = (size_t) fileSize.QuadPart;
+
+	// Map entire file
+	this->mappingHandle = CreateFileMappingA(
+		this->fileHandle,
+		nullptr,
+		PAGE_READONLY,
+		0,
+		0,
+		nullptr
+	);
+	if (this->mappingHandle == nullptr)
+	{
+		Log::error("Failed to create file mapping: " + filePath);
+		this->unmap();
+		return false;
+	}
+
+	this->data = (const uint8_t*) MapViewOfFile(
+		this->mappingHandle,
+		FILE_MAP_READ,
+		0,
+		0,
+		0
+	);
+	if (this->data == nullptr)
+	{
+		Log::error("Failed to map view of file: " + filePath);
+		this->unmap();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::unmap()
+{
+	if (this->data != nullptr)
+	{
+		UnmapViewOfFile(this->data);
+		this->data = nullptr;
+	}
+	if (this->mappingHandle != nullptr)
+	{
+		CloseHandle(this->mappingHandle);
+		this->mappingHandle = nullptr;
+	}
+	if (this->fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(this->fileHandle);
+		this->fileHandle = INVALID_HANDLE_VALUE;
+	}
+
+	this->size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+// Read-only memory mapped view of an entire file
+class MappedFile
+{
+private:
+	void* fileHandle;
+	void* mappingHandle;
+
+	const uint8_t* data;
+	size_t size;
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool map(const std::string& filePath);
+	void unmap();
+
+	inline const uint8_t* getData() const { return this->data; }
+	inline size_t getSize() const { return this->size; }
+	inline bool isMapped() const { return this->data != nullptr; }
+};
\ No newline at end of file
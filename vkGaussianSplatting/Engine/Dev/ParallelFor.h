@@ -0,0 +1,43 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Splits an index range into contiguous chunks and processes 
+// each chunk on its own thread
+class ParallelFor
+{
+public:
+	// Number of threads to use, such that each thread gets at least minElementsPerThread elements
+	static inline uint32_t getNumThreads(size_t numElements, size_t minElementsPerThread)
+	{
+		const size_t numHardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		const size_t maxNumThreads = std::max(numElements / std::max(minElementsPerThread, size_t(1)), size_t(1));
+
+		return (uint32_t) std::min(numHardwareThreads, maxNumThreads);
+	}
+
+	// Calls func(threadIndex, beginIndex, endIndex) once per thread. 
+	// The calling thread processes the first chunk itself.
+	template <typename Func>
+	static void run(size_t numElements, uint32_t numThreads, const Func& func)
+	{
+		numThreads = std::max(numThreads, 1u);
+		const size_t chunkSize = (numElements + numThreads - 1) / numThreads;
+
+		std::vector<std::thread> threads;
+		threads.reserve(numThreads - 1);
+		for (uint32_t i = 1; i < numThreads; ++i)
+		{
+			const size_t beginIndex = std::min(chunkSize * i, numElements);
+			const size_t endIndex = std::min(beginIndex + chunkSize, numElements);
+			threads.emplace_back(func, i, beginIndex, endIndex);
+		}
+
+		func(0u, size_t(0), std::min(chunkSize, numElements));
+
+		for (size_t i = 0; i < threads.size(); ++i)
+			threads[i].join();
+	}
+};
\ No newline at end of file
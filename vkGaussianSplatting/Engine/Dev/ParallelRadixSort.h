@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <type_traits>
+#include "ParallelFor.h"
+
+// Stable LSD radix sort of unsigned integer keys, where each key carries 
+// a 32 bit value along with it (usually an index into another array). 
+// Histograms are built per thread, and each thread then scatters its 
+// own chunk to offsets given by the prefix sum over all threads.
+template <typename KeyType>
+class ParallelRadixSort
+{
+private:
+	static_assert(std::is_unsigned<KeyType>::value, "Radix sort keys must be unsigned integers.");
+
+	static const uint32_t BITS_PER_PASS = 8;
+	static const uint32_t NUM_BINS = 1 << BITS_PER_PASS;
+	static const size_t MIN_ELEMENTS_PER_THREAD = 65536;
+
+public:
+	// Sorts keys in ascending order and reorders values the same way. 
+	// Only the lowest numKeyBits bits of each key are considered.
+	static void sort(
+		std::vector<KeyType>& keys, 
+		std::vector<uint32_t>& values, 
+		uint32_t numKeyBits = sizeof(KeyType) * 8)
+	{
+		assert(keys.size() == values.size());
+		assert(numKeyBits <= sizeof(KeyType) * 8);
+
+		const size_t numElements = keys.size();
+		const uint32_t numThreads = ParallelFor::getNumThreads(numElements, MIN_ELEMENTS_PER_THREAD);
+
+		std::vector<KeyType> tempKeys(numElements);
+		std::vector<uint32_t> tempValues(numElements);
+		std::vector<std::array<size_t, NUM_BINS>> threadOffsets(numThreads);
+
+		for (uint32_t shift = 0; shift < numKeyBits; shift += BITS_PER_PASS)
+		{
+			// The last pass may have fewer bits
+			const uint32_t digitMask = (1u << std::min(numKeyBits - shift, uint32_t(BITS_PER_PASS))) - 1u;
+
+			// Count digits per thread
+			ParallelFor::run(
+				numElements,
+				numThreads,
+				[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+				{
+					std::array<size_t, NUM_BINS>& histogram = threadOffsets[threadIndex];
+					histogram.fill(0);
+					for (size_t i = beginIndex; i < endIndex; ++i)
+						histogram[(keys[i] >> shift) & digitMask]++;
+				}
+			);
+
+			// Skip pass if all keys have the same digit
+			bool isPassTrivial = false;
+			for (uint32_t d = 0; d < NUM_BINS && !isPassTrivial; ++d)
+			{
+				size_t digitCount = 0;
+				for (uint32_t t = 0; t < numThreads; ++t)
+					digitCount += threadOffsets[t][d];
+
+				isPassTrivial = digitCount == numElements;
+			}
+			if (isPassTrivial)
+				continue;
+
+			// Exclusive prefix sum over digits, then threads
+			size_t offset = 0;
+			for (uint32_t d = 0; d < NUM_BINS; ++d)
+			{
+				for (uint32_t t = 0; t < numThreads; ++t)
+				{
+					const size_t digitCount = threadOffsets[t][d];
+					threadOffsets[t][d] = offset;
+					offset += digitCount;
+				}
+			}
+
+			// Scatter
+			ParallelFor::run(
+				numElements,
+				numThreads,
+				[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+				{
+					std::array<size_t, NUM_BINS>& offsets = threadOffsets[threadIndex];
+					for (size_t i = beginIndex; i < endIndex; ++i)
+					{
+						const size_t dstIndex = offsets[(keys[i] >> shift) & digitMask]++;
+						tempKeys[dstIndex] = keys[i];
+						tempValues[dstIndex] = values[i];
+					}
+				}
+			);
+
+			keys.swap(tempKeys);
+			values.swap(tempValues);
+		}
+	}
+};
\ No newline at end of file
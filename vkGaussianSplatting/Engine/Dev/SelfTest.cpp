@@ -0,0 +1,309 @@
+#include "pch.h"
+#include <cmath>
+#include <numeric>
+#include <random>
+#include "SelfTest.h"
+#include "ParallelRadixSort.h"
+#include "../Graphics/PlyReader.h"
+
+void SelfTest::check(bool condition, const std::string& description)
+{
+	this->numChecks++;
+	if (!condition)
+	{
+		this->numFailedChecks++;
+		Log::warning("Self test failed: " + description);
+	}
+}
+
+std::string SelfTest::getPlyPath()
+{
+	return (std::filesystem::temp_directory_path() / "vkGaussianSplattingSelfTest.ply").string();
+}
+
+bool SelfTest::openPly(
+	const std::string& header,
+	const std::vector<float>& vertexData,
+	size_t numPaddingBytes,
+	PlyReader& outputReader)
+{
+	// Unmap the previous file before overwriting it
+	outputReader.close();
+
+	const std::string filePath = SelfTest::getPlyPath();
+	{
+		std::ofstream file(filePath, std::ios::binary);
+		file.write(header.data(), header.size());
+		const std::vector<char> padding(numPaddingBytes, 0);
+		file.write(padding.data(), padding.size());
+		file.write((const char*) vertexData.data(), vertexData.size() * sizeof(float));
+	}
+
+	return outputReader.open(filePath);
+}
+
+void SelfTest::testPlyReader()
+{
+	// 3 vertices of x, y, z, opacity
+	const std::vector<float> vertexData =
+	{
+		0.0f, 1.0f, 2.0f, 0.5f,
+		3.0f, 4.0f, 5.0f, 0.25f,
+		6.0f, 7.0f, 8.0f, 0.125f
+	};
+	const std::string vertexHeader =
+		"element vertex 3\n"
+		"property float x\n"
+		"property float y\n"
+		"property float z\n"
+		"property float opacity\n";
+
+	PlyReader reader;
+	uint32_t offset = 0;
+
+	// Valid file
+	this->check(
+		SelfTest::openPly("ply\nformat binary_little_endian 1.0\n" + vertexHeader + "end_header\n", vertexData, 0, reader),
+		"PlyReader opens a valid file"
+	);
+	this->check(reader.getNumVertices() == 3, "PlyReader vertex count");
+	this->check(reader.getVertexStride() == 4 * sizeof(float), "PlyReader vertex stride");
+	this->check(
+		reader.getFloatPropertyOffset("opacity", offset) && offset == 3 * sizeof(float),
+		"PlyReader property offset"
+	);
+	this->check(
+		reader.isOpen() && PlyReader::readFloat(reader.getVertexRecord(2), offset) == 0.125f,
+		"PlyReader reads the last vertex"
+	);
+	this->check(!reader.hasProperty("f_dc_0"), "PlyReader missing property");
+	reader.close();
+
+	// CRLF line endings
+	std::string crlfHeader = "ply\nformat binary_little_endian 1.0\n" + vertexHeader + "end_header\n";
+	for (size_t pos = crlfHeader.find('\n'); pos != std::string::npos; pos = crlfHeader.find('\n', pos + 2))
+		crlfHeader.insert(pos, "\r");
+	this->check(SelfTest::openPly(crlfHeader, vertexData, 0, reader), "PlyReader opens a file with CRLF line endings");
+	this->check(
+		reader.isOpen() && reader.getNumVertices() == 3 &&
+		PlyReader::readFloat(reader.getVertexRecord(1), 0) == 3.0f,
+		"PlyReader reads a file with CRLF line endings"
+	);
+	reader.close();
+
+	// Element before the vertices, whose data is skipped
+	const std::string precedingElementHeader =
+		"ply\nformat binary_little_endian 1.0\n"
+		"element camera 2\n"
+		"property float fx\n"
+		"property uchar id\n" +
+		vertexHeader +
+		"end_header\n";
+	this->check(
+		SelfTest::openPly(precedingElementHeader, vertexData, 2 * (sizeof(float) + 1), reader),
+		"PlyReader opens a file with an element before the vertices"
+	);
+	this->check(
+		reader.isOpen() && PlyReader::readFloat(reader.getVertexRecord(1), sizeof(float)) == 4.0f,
+		"PlyReader skips the element before the vertices"
+	);
+	reader.close();
+
+	// Rejected files
+	const std::vector<float> truncatedVertexData(vertexData.begin(), vertexData.end() - 1);
+	this->check(
+		!SelfTest::openPly("ply\nformat binary_little_endian 1.0\n" + vertexHeader + "end_header\n", truncatedVertexData, 0, reader),
+		"PlyReader rejects truncated vertex data"
+	);
+	this->check(
+		!SelfTest::openPly("ply\nformat ascii 1.0\n" + vertexHeader + "end_header\n", vertexData, 0, reader),
+		"PlyReader rejects ascii files"
+	);
+	this->check(
+		!SelfTest::openPly("ply\nformat binary_little_endian 1.0\n" + vertexHeader, vertexData, 0, reader),
+		"PlyReader rejects a file without end_header"
+	);
+	this->check(
+		!SelfTest::openPly(
+			"ply\nformat binary_little_endian 1.0\nelement vertex 3\nproperty list uchar int indices\nend_header\n",
+			vertexData,
+			0,
+			reader
+		),
+		"PlyReader rejects list properties on vertices"
+	);
+
+	reader.close();
+	std::filesystem::remove(SelfTest::getPlyPath());
+}
+
+void SelfTest::testExp4()
+{
+	// Relative error against a double precision reference, over the unclamped range
+	const uint32_t numSteps = 100000;
+	double maxRelativeError = 0.0;
+	for (uint32_t i = 0; i <= numSteps; ++i)
+	{
+		const float t = float(i) / float(numSteps);
+		const glm::vec4 x(-87.0f + 175.0f * t, -1.0f + 2.0f * t, -10.0f * t, 10.0f * t);
+		const glm::vec4 y = SMath::exp4(x);
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			const double reference = std::exp(double(x[j]));
+			maxRelativeError = std::max(maxRelativeError, std::abs(double(y[j]) - reference) / reference);
+		}
+	}
+	this->check(maxRelativeError < 2e-7, "SMath::exp4 relative error " + std::to_string(maxRelativeError));
+
+#ifdef SMATH_SSE2
+	// Inputs outside the range are clamped, instead of turning into inf or denormals
+	const glm::vec4 clamped = SMath::exp4(glm::vec4(-1000.0f, 1000.0f, 0.0f, 1.0f));
+	this->check(
+		clamped.x > 0.0f && std::isfinite(clamped.y) && clamped.z == 1.0f,
+		"SMath::exp4 clamps its input"
+	);
+#endif
+}
+
+template <typename KeyType>
+void SelfTest::testParallelRadixSort(size_t numElements, uint32_t numKeyBits, KeyType maxKey)
+{
+	std::mt19937_64 random(numElements + numKeyBits);
+	std::uniform_int_distribution<KeyType> keyDistribution(0, maxKey);
+
+	std::vector<KeyType> keys(numElements);
+	for (size_t i = 0; i < numElements; ++i)
+		keys[i] = keyDistribution(random);
+	std::vector<uint32_t> values(numElements);
+	std::iota(values.begin(), values.end(), 0u);
+
+	// Stable reference over the lowest numKeyBits bits
+	const KeyType keyMask = numKeyBits < sizeof(KeyType) * 8 ? (KeyType(1) << numKeyBits) - 1 : ~KeyType(0);
+	std::vector<uint32_t> referenceValues = values;
+	std::stable_sort(
+		referenceValues.begin(),
+		referenceValues.end(),
+		[&](uint32_t a, uint32_t b) { return (keys[a] & keyMask) < (keys[b] & keyMask); }
+	);
+
+	const std::vector<KeyType> unsortedKeys = keys;
+	ParallelRadixSort<KeyType>::sort(keys, values, numKeyBits);
+
+	bool isValid = values == referenceValues;
+	for (size_t i = 0; i < numElements && isValid; ++i)
+		isValid = keys[i] == unsortedKeys[values[i]];
+
+	this->check(
+		isValid,
+		"ParallelRadixSort of " + std::to_string(numElements) + " " + std::to_string(sizeof(KeyType) * 8) +
+		" bit keys, " + std::to_string(numKeyBits) + " key bits"
+	);
+}
+
+void SelfTest::testParallelRadixSorts()
+{
+	this->testParallelRadixSort<uint32_t>(0, 32, ~0u);
+	this->testParallelRadixSort<uint32_t>(1000, 32, ~0u);
+
+	// Enough elements to be split over several threads, with many equal keys to check stability
+	this->testParallelRadixSort<uint32_t>(500000, 32, 1000u);
+	this->testParallelRadixSort<uint32_t>(500000, 20, ~0u);
+	this->testParallelRadixSort<uint64_t>(500000, 64, ~0ull);
+	this->testParallelRadixSort<uint64_t>(500000, 63, ~0ull >> 1);
+
+	// Passes where every key has the same digit are skipped
+	this->testParallelRadixSort<uint64_t>(500000, 64, 255ull);
+}
+
+void SelfTest::testSpaceFillingCurves()
+{
+	// Z-order against interleaving bit by bit, with x in the lowest bit
+	auto interleaveBits = [](glm::uvec3 position, uint32_t numBitsPerAxis)
+	{
+		uint64_t key = 0;
+		for (uint32_t i = 0; i < numBitsPerAxis; ++i)
+			for (uint32_t axis = 0; axis < 3; ++axis)
+				key |= uint64_t((position[axis] >> i) & 1u) << (i * 3 + axis);
+		return key;
+	};
+
+	std::mt19937 random(0);
+	std::uniform_int_distribution<uint32_t> wideDistribution(0, (1u << SMath::WIDE_CURVE_BITS_PER_AXIS) - 1);
+	bool isZorderValid = true;
+	bool isWideZorderValid = true;
+	for (uint32_t i = 0; i < 10000; ++i)
+	{
+		const glm::uvec3 widePosition(wideDistribution(random), wideDistribution(random), wideDistribution(random));
+		const glm::uvec3 position = widePosition & glm::uvec3(1023u);
+
+		isZorderValid = isZorderValid && SMath::encodeZorderCurve(position) == interleaveBits(position, 10);
+		isWideZorderValid = isWideZorderValid &&
+			SMath::encodeZorderCurveWide(widePosition) == interleaveBits(widePosition, SMath::WIDE_CURVE_BITS_PER_AXIS);
+	}
+	const glm::uvec3 maxPosition(glm::uvec3((1u << SMath::WIDE_CURVE_BITS_PER_AXIS) - 1));
+	isWideZorderValid = isWideZorderValid && SMath::encodeZorderCurveWide(maxPosition) == (~0ull >> 1);
+	this->check(isZorderValid, "SMath::encodeZorderCurve interleaves bits");
+	this->check(isWideZorderValid, "SMath::encodeZorderCurveWide interleaves bits");
+
+	// The Hilbert curve starts at the origin, so its first 8^n indices fill the cube
+	// of side 2^n there. Each index must be used once, by neighboring cells.
+	const uint32_t cubeSize = 16;
+	const uint32_t numCells = cubeSize * cubeSize * cubeSize;
+	std::vector<glm::uvec3> cellsByIndex(numCells, glm::uvec3(~0u));
+	bool isHilbertBijective = true;
+	for (uint32_t z = 0; z < cubeSize; ++z)
+	{
+		for (uint32_t y = 0; y < cubeSize; ++y)
+		{
+			for (uint32_t x = 0; x < cubeSize; ++x)
+			{
+				const uint64_t index = SMath::encodeHilbertCurve(glm::uvec3(x, y, z));
+				if (index >= numCells || cellsByIndex[index].x != ~0u)
+				{
+					isHilbertBijective = false;
+					continue;
+				}
+
+				cellsByIndex[index] = glm::uvec3(x, y, z);
+			}
+		}
+	}
+	this->check(isHilbertBijective, "SMath::encodeHilbertCurve maps a cube at the origin to unique indices");
+
+	bool isHilbertContinuous = isHilbertBijective;
+	for (uint32_t i = 1; i < numCells && isHilbertContinuous; ++i)
+	{
+		const glm::ivec3 step = glm::abs(glm::ivec3(cellsByIndex[i]) - glm::ivec3(cellsByIndex[i - 1]));
+		isHilbertContinuous = step.x + step.y + step.z == 1;
+	}
+	this->check(isHilbertContinuous, "SMath::encodeHilbertCurve steps between neighboring cells");
+}
+
+SelfTest::SelfTest()
+	: numChecks(0),
+	numFailedChecks(0)
+{
+}
+
+bool SelfTest::run()
+{
+	this->numChecks = 0;
+	this->numFailedChecks = 0;
+
+	// Rejected inputs are expected to log errors
+	Log::setUsePopups(false);
+
+	this->testPlyReader();
+	this->testExp4();
+	this->testParallelRadixSorts();
+	this->testSpaceFillingCurves();
+
+	Log::setUsePopups(true);
+
+	Log::write(
+		"Self test: " + std::to_string(this->numChecks - this->numFailedChecks) + " of " +
+		std::to_string(this->numChecks) + " checks passed."
+	);
+
+	return this->numFailedChecks == 0;
+}
\ No newline at end of file
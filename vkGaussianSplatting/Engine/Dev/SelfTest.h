@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class PlyReader;
+
+// Checks of the CPU side code that needs no GPU, like the ply import.
+// Run with --self-test instead of a scene.
+class SelfTest
+{
+private:
+	uint32_t numChecks;
+	uint32_t numFailedChecks;
+
+	void check(bool condition, const std::string& description);
+
+	static std::string getPlyPath();
+
+	// Writes a temporary ply file with the given header and vertex data, and tries to open it
+	static bool openPly(
+		const std::string& header,
+		const std::vector<float>& vertexData,
+		size_t numPaddingBytes,
+		PlyReader& outputReader);
+
+	void testPlyReader();
+	void testExp4();
+
+	template <typename KeyType>
+	void testParallelRadixSort(size_t numElements, uint32_t numKeyBits, KeyType maxKey);
+	void testParallelRadixSorts();
+	void testSpaceFillingCurves();
+
+public:
+	SelfTest();
+
+	// Returns true if every check passed
+	bool run();
+};
\ No newline at end of file
@@ -32,7 +32,8 @@ Engine::~Engine()
 void Engine::init(Scene* initialScene)
 {
 	// Init subsystems
-	this->window.init(this->renderer, "3D Gaussian Splatting", 1280, 720);
+	const std::string windowTitle = "3D Gaussian Splatting";
+	this->window.init(this->renderer, windowTitle, 1280, 720);
 	this->renderer.init(this->resourceManager);
 	this->resourceManager.init(this->renderer.getGfxAllocContext());
 	this->sceneManager.init(this->window, this->renderer, this->resourceManager);
@@ -53,13 +54,28 @@ void Engine::init(Scene* initialScene)
 		this->beginImgui();
 
 		// Scene logic
+		const bool wasLoadingScene = this->sceneManager.isLoadingScene();
 		this->sceneManager.updateToNextScene();
 		this->sceneManager.update();
 
 		this->endImgui();
 
-		// Render
-		this->renderer.draw(this->sceneManager.getCurrentScene());
+		// Show loading progress while the next scene is loaded in the background
+		if (this->sceneManager.isLoadingScene())
+		{
+			this->window.setTitle(
+				windowTitle + " (loading scene: " + 
+				std::to_string(int(this->sceneManager.getLoadingProgress() * 100.0f)) + "%)"
+			);
+		}
+		else if (wasLoadingScene)
+		{
+			this->window.setTitle(windowTitle);
+		}
+
+		// Render, as long as a scene has finished loading
+		if (this->sceneManager.hasCurrentScene())
+			this->renderer.draw(this->sceneManager.getCurrentScene());
 
 #ifdef _DEBUG
 		if (Input::isKeyPressed(Keys::T))
@@ -77,9 +93,27 @@ void Engine::init(Scene* initialScene)
 		Time::endGodTimer();
 	}
 
-	// Cleanup
-	this->renderer.startCleanup();
+	// Cleanup (scene manager first, to wait for scenes still loading)
 	this->sceneManager.cleanup();
+	this->renderer.startCleanup();
 	this->resourceManager.cleanup();
 	this->renderer.cleanup();
 }
+
+void Engine::runSortBenchmark(const SortBenchmarkSettings& settings)
+{
+	// Init subsystems, but no scene
+	this->window.init(this->renderer, "3D Gaussian Splatting (sort benchmark)", 1280, 720);
+	this->renderer.init(this->resourceManager);
+	this->resourceManager.init(this->renderer.getGfxAllocContext());
+
+	SortBenchmark sortBenchmark;
+	sortBenchmark.init(this->renderer.getGfxAllocContext());
+	sortBenchmark.run(settings);
+	sortBenchmark.cleanup();
+
+	// Cleanup
+	this->renderer.startCleanup();
+	this->resourceManager.cleanup();
+	this->renderer.cleanup();
+}
\ No newline at end of file
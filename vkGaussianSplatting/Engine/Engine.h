@@ -3,6 +3,7 @@
 #include "Application/SceneManager.h"
 #include "Graphics/Renderer.h"
 #include "ResourceManager.h"
+#include "Graphics/Sort/SortBenchmark.h"
 
 class Engine
 {
@@ -20,4 +21,7 @@ public:
 	~Engine();
 
 	void init(Scene* initialScene);
+
+	// Benchmarks the GPU sorts on synthetic keys instead of rendering a scene
+	void runSortBenchmark(const SortBenchmarkSettings& settings);
 };
\ No newline at end of file
@@ -75,6 +75,18 @@ void Buffer::createGpuBuffer(
 	VkDeviceSize bufferSize, 
 	const void* cpuData)
 {
+	// Without data, the buffer is left uninitialized for later transfers
+	if (cpuData == nullptr)
+	{
+		this->createBuffer(
+			gfxAllocContext,
+			bufferSize,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT | usageFlags,
+			0
+		);
+		return;
+	}
+
 	// Create staging buffer
 	StagingBuffer stagingBuffer;
 	stagingBuffer.createStagingBuffer(
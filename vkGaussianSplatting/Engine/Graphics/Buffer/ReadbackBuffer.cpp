@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "ReadbackBuffer.h"
+
+ReadbackBuffer::ReadbackBuffer()
+	: gfxAllocContext(nullptr)
+{
+}
+
+void ReadbackBuffer::createReadbackBuffer(
+	const GfxAllocContext& gfxAllocContext,
+	VkDeviceSize bufferSize,
+	uint32_t numBuffers)
+{
+	this->gfxAllocContext = &gfxAllocContext;
+
+	this->createBuffer(
+		gfxAllocContext,
+		bufferSize,
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+		VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		numBuffers
+	);
+
+	// Buffers are created persistently mapped
+	this->mappedBuffers.resize(numBuffers);
+	for (uint32_t i = 0; i < numBuffers; ++i)
+	{
+		VmaAllocationInfo allocationInfo{};
+		vmaGetAllocationInfo(
+			*gfxAllocContext.vmaAllocator,
+			this->getVmaAllocation(i),
+			&allocationInfo
+		);
+		this->mappedBuffers[i] = allocationInfo.pMappedData;
+		std::memset(this->mappedBuffers[i], 0, size_t(bufferSize));
+	}
+}
+
+const void* ReadbackBuffer::getMappedData(uint32_t index) const
+{
+	// No-op for host coherent memory
+	vmaInvalidateAllocation(
+		*this->gfxAllocContext->vmaAllocator,
+		this->getVmaAllocation(index),
+		0,
+		VK_WHOLE_SIZE
+	);
+
+	return this->mappedBuffers[index];
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Buffer.h"
+
+// Persistently mapped buffers the GPU copies results into, one per frame in flight by default. 
+// Results of a frame can be read once the fence of that frame has been waited on.
+class ReadbackBuffer : public Buffer
+{
+private:
+	std::vector<void*> mappedBuffers;
+
+	const GfxAllocContext* gfxAllocContext;
+
+public:
+	ReadbackBuffer();
+
+	void createReadbackBuffer(
+		const GfxAllocContext& gfxAllocContext,
+		VkDeviceSize bufferSize,
+		uint32_t numBuffers = GfxSettings::FRAMES_IN_FLIGHT);
+
+	// Makes GPU writes visible to the CPU before returning the mapped memory
+	const void* getMappedData(uint32_t index) const;
+
+	inline const VkBuffer& getVkBuffer(uint32_t index) const { return Buffer::getVkBuffer(index); }
+	inline const VmaAllocation& getVmaAllocation(uint32_t index) const { return Buffer::getVmaAllocation(index); }
+};
\ No newline at end of file
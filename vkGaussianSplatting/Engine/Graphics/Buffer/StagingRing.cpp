@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "StagingRing.h"
+
+StagingRing::StagingRing()
+	: gfxAllocContext(nullptr),
+	slotSize(0),
+	currentSlot(0)
+{
+}
+
+StagingRing::~StagingRing()
+{
+}
+
+void StagingRing::create(
+	const GfxAllocContext& gfxAllocContext, 
+	VkDeviceSize slotSize, 
+	uint32_t numSlots)
+{
+	this->gfxAllocContext = &gfxAllocContext;
+	this->slotSize = slotSize;
+	this->currentSlot = numSlots - 1;
+
+	// Staging buffers
+	this->stagingBuffers.resize(numSlots);
+	this->mappedSlots.resize(numSlots);
+	for (uint32_t i = 0; i < numSlots; ++i)
+	{
+		this->stagingBuffers[i].createStagingBuffer(gfxAllocContext, slotSize);
+
+		// Staging buffers are created persistently mapped
+		VmaAllocationInfo allocationInfo{};
+		vmaGetAllocationInfo(
+			*gfxAllocContext.vmaAllocator, 
+			this->stagingBuffers[i].getVmaAllocation(), 
+			&allocationInfo
+		);
+		this->mappedSlots[i] = allocationInfo.pMappedData;
+	}
+
+	// Command buffers are re-recorded every time a slot is reused
+	this->commandPool.create(
+		*gfxAllocContext.device, 
+		*gfxAllocContext.queueFamilies, 
+		VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+	);
+	this->commandBuffers.createCommandBuffers(
+		*gfxAllocContext.device, 
+		this->commandPool, 
+		numSlots
+	);
+
+	// Fences start signaled, since no slot is in use yet
+	this->fences.create(
+		*gfxAllocContext.device, 
+		numSlots, 
+		VK_FENCE_CREATE_SIGNALED_BIT
+	);
+}
+
+void StagingRing::cleanup()
+{
+	this->flush();
+
+	this->fences.cleanup();
+	this->commandBuffers.cleanup();
+	this->commandPool.cleanup();
+
+	for (size_t i = 0; i < this->stagingBuffers.size(); ++i)
+		this->stagingBuffers[i].cleanup();
+	this->stagingBuffers.clear();
+	this->mappedSlots.clear();
+}
+
+void* StagingRing::acquireSlot()
+{
+	this->currentSlot = (this->currentSlot + 1) % (uint32_t) this->stagingBuffers.size();
+
+	// Wait for the previous copy from this slot
+	vkWaitForFences(
+		this->gfxAllocContext->device->getVkDevice(),
+		1,
+		&this->fences[this->currentSlot],
+		VK_TRUE,
+		UINT64_MAX
+	);
+
+	return this->mappedSlots[this->currentSlot];
+}
+
+void StagingRing::submitSlot(const StagingRingCopy* copies, uint32_t numCopies)
+{
+	CommandBuffer& commandBuffer = this->commandBuffers[this->currentSlot];
+	commandBuffer.resetAndBegin();
+
+	for (uint32_t i = 0; i < numCopies; ++i)
+	{
+		assert(copies[i].srcOffset + copies[i].numBytes <= this->slotSize);
+
+		// Copy
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = copies[i].srcOffset;
+		copyRegion.dstOffset = copies[i].dstOffset;
+		copyRegion.size = copies[i].numBytes;
+		vkCmdCopyBuffer(
+			commandBuffer.getVkCommandBuffer(),
+			this->stagingBuffers[this->currentSlot].getVkBuffer(),
+			copies[i].dstBuffer,
+			1,
+			&copyRegion
+		);
+
+		// Make the copied data visible to later compute passes
+		commandBuffer.bufferMemoryBarrier(
+			VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COPY_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			copies[i].dstBuffer,
+			VK_WHOLE_SIZE
+		);
+	}
+
+	commandBuffer.end();
+
+	// Submit
+	this->fences.reset(this->currentSlot);
+	VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer.getVkCommandBuffer();
+	std::lock_guard<std::mutex> queueLock(this->gfxAllocContext->queueFamilies->getQueueMutex());
+	if (vkQueueSubmit(
+		this->gfxAllocContext->queueFamilies->getVkGraphicsQueue(),
+		1,
+		&submitInfo,
+		this->fences[this->currentSlot]) != VK_SUCCESS)
+	{
+		Log::error("Failed to submit staging ring copy.");
+	}
+}
+
+void StagingRing::flush()
+{
+	for (uint32_t i = 0; i < (uint32_t) this->stagingBuffers.size(); ++i)
+	{
+		vkWaitForFences(
+			this->gfxAllocContext->device->getVkDevice(),
+			1,
+			&this->fences[i],
+			VK_TRUE,
+			UINT64_MAX
+		);
+	}
+}
\ No newline at end of file
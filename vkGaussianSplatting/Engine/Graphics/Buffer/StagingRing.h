@@ -0,0 +1,54 @@
+#pragma once
+
+#include "StagingBuffer.h"
+#include "../Vulkan/CommandPool.h"
+#include "../Vulkan/CommandBufferArray.h"
+#include "../Vulkan/FenceArray.h"
+
+// Region of a staging slot to copy into a GPU buffer
+struct StagingRingCopy
+{
+	VkBuffer dstBuffer = VK_NULL_HANDLE;
+	VkDeviceSize srcOffset = 0;
+	VkDeviceSize dstOffset = 0;
+	VkDeviceSize numBytes = 0;
+};
+
+// Ring of persistently mapped staging buffers, for streaming data to the GPU in chunks. 
+// Each slot has its own command buffer and fence, so the CPU can fill the 
+// next slot while copies from earlier slots are still in flight.
+class StagingRing
+{
+private:
+	std::vector<StagingBuffer> stagingBuffers;
+	std::vector<void*> mappedSlots;
+
+	CommandPool commandPool;
+	CommandBufferArray commandBuffers;
+	FenceArray fences;
+
+	const GfxAllocContext* gfxAllocContext;
+	VkDeviceSize slotSize;
+	uint32_t currentSlot;
+
+public:
+	StagingRing();
+	~StagingRing();
+
+	void create(
+		const GfxAllocContext& gfxAllocContext, 
+		VkDeviceSize slotSize, 
+		uint32_t numSlots);
+	void cleanup();
+
+	// Waits until the next slot is no longer in use, and returns its mapped memory
+	void* acquireSlot();
+
+	// Copies regions of the acquired slot into one or more buffers
+	void submitSlot(const StagingRingCopy* copies, uint32_t numCopies);
+
+	// Waits for all submitted copies to finish
+	void flush();
+
+	inline VkDeviceSize getSlotSize() const { return this->slotSize; }
+};
\ No newline at end of file
@@ -7,9 +7,10 @@ void StorageBuffer::createGpuBuffer(
 	const void* data,
 	VkBufferUsageFlagBits extraFlags)
 {
+	// Storage buffers are also copied from, for readbacks and between sort buffers
 	Buffer::createGpuBuffer(
 		gfxAllocContext,
-		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | extraFlags,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | extraFlags,
 		bufferSize,
 		data
 	);
@@ -0,0 +1,229 @@
+#include "pch.h"
+#include <cstring>
+#include "GaussianCache.h"
+
+bool GaussianCache::createHeader(
+	const std::string& sourceFilePath, 
+	uint32_t gaussianOrdering, 
+	GaussianCacheHeader& outputHeader)
+{
+	MappedFile sourceFile;
+	if (!sourceFile.map(sourceFilePath))
+		return false;
+
+	std::error_code errorCode;
+	const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(sourceFilePath, errorCode);
+	if (errorCode)
+		return false;
+
+	outputHeader = {};
+	outputHeader.magic = GaussianCache::MAGIC;
+	outputHeader.version = GaussianCache::VERSION;
+	outputHeader.sourceFileSize = (uint64_t) sourceFile.getSize();
+	outputHeader.sourceWriteTime = (uint64_t) writeTime.time_since_epoch().count();
+	outputHeader.sourceFingerprint = GaussianCache::getSourceFingerprint(sourceFile);
+	outputHeader.gaussianOrdering = gaussianOrdering;
+	outputHeader.gaussianDataSize = (uint32_t) sizeof(GaussianData);
+	outputHeader.gaussianDataOffset = 
+		(sizeof(GaussianCacheHeader) + GaussianCache::DATA_ALIGNMENT - 1) / GaussianCache::DATA_ALIGNMENT * GaussianCache::DATA_ALIGNMENT;
+
+	return true;
+}
+
+uint64_t GaussianCache::getSourceFingerprint(const MappedFile& sourceFile)
+{
+	// Hashing every byte would take as long as parsing the file, so the 
+	// FNV-1a hash is instead computed over evenly spaced blocks. The first 
+	// block covers the .ply header.
+	const uint64_t NUM_BLOCKS = 64;
+	const uint64_t BLOCK_SIZE = 4096;
+
+	const uint8_t* data = sourceFile.getData();
+	const uint64_t fileSize = (uint64_t) sourceFile.getSize();
+	const uint64_t blockStride = std::max(fileSize / NUM_BLOCKS, BLOCK_SIZE);
+
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (uint64_t blockStart = 0; blockStart < fileSize; blockStart += blockStride)
+	{
+		const uint64_t blockEnd = std::min(blockStart + BLOCK_SIZE, fileSize);
+		for (uint64_t i = blockStart; i < blockEnd; ++i)
+		{
+			hash ^= data[i];
+			hash *= 0x100000001b3ull;
+		}
+	}
+
+	return hash;
+}
+
+GaussianCache::GaussianCache()
+	: gaussianData(nullptr),
+	numGaussians(0),
+	shDegree(0)
+{
+}
+
+GaussianCache::~GaussianCache()
+{
+	this->close();
+}
+
+bool GaussianCache::open(
+	const std::string& cacheFilePath, 
+	const std::string& sourceFilePath, 
+	uint32_t gaussianOrdering)
+{
+	this->close();
+
+	if (!std::filesystem::exists(cacheFilePath))
+		return false;
+
+	// Expected header for the current source file
+	GaussianCacheHeader expectedHeader{};
+	if (!GaussianCache::createHeader(sourceFilePath, gaussianOrdering, expectedHeader))
+		return false;
+
+	if (!this->file.map(cacheFilePath))
+		return false;
+
+	// Validate header
+	GaussianCacheHeader header{};
+	if (this->file.getSize() < sizeof(header))
+	{
+		Log::warning("Gaussian cache is truncated and will be recreated: " + cacheFilePath);
+		this->close();
+		return false;
+	}
+	std::memcpy(&header, this->file.getData(), sizeof(header));
+	if (header.magic != expectedHeader.magic ||
+		header.version != expectedHeader.version ||
+		header.sourceFileSize != expectedHeader.sourceFileSize ||
+		header.sourceWriteTime != expectedHeader.sourceWriteTime ||
+		header.sourceFingerprint != expectedHeader.sourceFingerprint ||
+		header.gaussianOrdering != expectedHeader.gaussianOrdering ||
+		header.gaussianDataSize != expectedHeader.gaussianDataSize ||
+		header.gaussianDataOffset != expectedHeader.gaussianDataOffset)
+	{
+		Log::write("Gaussian cache is out of date and will be recreated: " + cacheFilePath);
+		this->close();
+		return false;
+	}
+	if (header.shDegree > GaussianShData::MAX_DEGREE)
+	{
+		Log::warning("Gaussian cache has an invalid spherical harmonics degree and will be recreated: " + cacheFilePath);
+		this->close();
+		return false;
+	}
+	if (header.gaussianDataOffset + header.numGaussians * sizeof(GaussianData) > this->file.getSize())
+	{
+		Log::warning("Gaussian cache is truncated and will be recreated: " + cacheFilePath);
+		this->close();
+		return false;
+	}
+
+	this->gaussianData = (const GaussianData*) (this->file.getData() + header.gaussianDataOffset);
+	this->numGaussians = (size_t) header.numGaussians;
+	this->shDegree = header.shDegree;
+
+	return true;
+}
+
+void GaussianCache::close()
+{
+	this->file.unmap();
+	this->gaussianData = nullptr;
+	this->numGaussians = 0;
+	this->shDegree = 0;
+}
+
+GaussianCacheWriter::GaussianCacheWriter()
+	: numExpectedGaussians(0),
+	numWrittenGaussians(0)
+{
+}
+
+GaussianCacheWriter::~GaussianCacheWriter()
+{
+	// Discard unfinished cache
+	if (this->file.is_open())
+	{
+		this->file.close();
+
+		std::error_code errorCode;
+		std::filesystem::remove(this->tempFilePath, errorCode);
+	}
+}
+
+bool GaussianCacheWriter::begin(
+	const std::string& cacheFilePath, 
+	const std::string& sourceFilePath, 
+	uint32_t gaussianOrdering, 
+	uint32_t shDegree, 
+	size_t numGaussians)
+{
+	GaussianCacheHeader header{};
+	if (!GaussianCache::createHeader(sourceFilePath, gaussianOrdering, header))
+	{
+		Log::warning("Could not read source file when writing gaussian cache: " + sourceFilePath);
+		return false;
+	}
+	header.shDegree = shDegree;
+	header.numGaussians = (uint64_t) numGaussians;
+
+	// Write to a temporary file first, so a partially written cache is never opened
+	this->cacheFilePath = cacheFilePath;
+	this->tempFilePath = cacheFilePath + ".tmp";
+	this->file.open(this->tempFilePath, std::ios::binary | std::ios::trunc);
+	if (!this->file)
+	{
+		Log::warning("Could not create gaussian cache: " + this->tempFilePath);
+		return false;
+	}
+
+	const std::vector<char> padding(header.gaussianDataOffset - sizeof(header), 0);
+	this->file.write((const char*) &header, sizeof(header));
+	this->file.write(padding.data(), padding.size());
+
+	this->numExpectedGaussians = header.numGaussians;
+	this->numWrittenGaussians = 0;
+
+	return true;
+}
+
+void GaussianCacheWriter::write(const GaussianData* gaussianData, size_t numGaussians)
+{
+	if (!this->file.is_open())
+		return;
+
+	this->file.write((const char*) gaussianData, numGaussians * sizeof(GaussianData));
+	this->numWrittenGaussians += numGaussians;
+}
+
+bool GaussianCacheWriter::end()
+{
+	if (!this->file.is_open())
+		return false;
+
+	const bool writeSucceeded = 
+		this->file.good() && 
+		this->numWrittenGaussians == this->numExpectedGaussians;
+	this->file.close();
+
+	std::error_code errorCode;
+	if (!writeSucceeded)
+	{
+		Log::warning("Failed to write gaussian cache: " + this->tempFilePath);
+		std::filesystem::remove(this->tempFilePath, errorCode);
+		return false;
+	}
+
+	std::filesystem::rename(this->tempFilePath, this->cacheFilePath, errorCode);
+	if (errorCode)
+	{
+		Log::warning("Failed to replace gaussian cache: " + this->cacheFilePath);
+		std::filesystem::remove(this->tempFilePath, errorCode);
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
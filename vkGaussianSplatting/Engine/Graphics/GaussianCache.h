@@ -0,0 +1,98 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../Dev/MappedFile.h"
+
+struct GaussianCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	// Source .ply file the cache was created from
+	uint64_t sourceFileSize;
+	uint64_t sourceWriteTime;
+	uint64_t sourceFingerprint;
+
+	// Layout of the gaussian array
+	uint32_t gaussianOrdering;
+	uint32_t gaussianDataSize;
+	uint32_t shDegree;
+	uint32_t padding;
+	uint64_t numGaussians;
+	uint64_t gaussianDataOffset;
+};
+
+// Pre-baked gaussians, stored already activated and reordered, so they can 
+// be uploaded directly from the memory mapped file on later launches.
+// A cache is only valid for the exact source file and ordering it was created with.
+class GaussianCache
+{
+private:
+	friend class GaussianCacheWriter;
+
+	static const uint32_t MAGIC = 0x48435347; // "GSCH"
+	static const uint32_t VERSION = 2;
+	static const uint64_t DATA_ALIGNMENT = 64;
+
+	MappedFile file;
+
+	const GaussianData* gaussianData;
+	size_t numGaussians;
+	uint32_t shDegree;
+
+	static bool createHeader(
+		const std::string& sourceFilePath, 
+		uint32_t gaussianOrdering, 
+		GaussianCacheHeader& outputHeader);
+	static uint64_t getSourceFingerprint(const MappedFile& sourceFile);
+
+public:
+	GaussianCache();
+	~GaussianCache();
+
+	// Maps the cache if it exists and is still valid for the source file
+	bool open(
+		const std::string& cacheFilePath, 
+		const std::string& sourceFilePath, 
+		uint32_t gaussianOrdering);
+	void close();
+
+	static inline std::string getCacheFilePath(const std::string& sourceFilePath) { return sourceFilePath + ".gscache"; }
+
+	inline const GaussianData* getGaussianData() const { return this->gaussianData; }
+	inline size_t getNumGaussians() const { return this->numGaussians; }
+	inline uint32_t getShDegree() const { return this->shDegree; }
+	inline bool isOpen() const { return this->gaussianData != nullptr; }
+};
+
+// Writes a cache file in chunks, so the gaussians never 
+// need to exist in CPU memory all at once
+class GaussianCacheWriter
+{
+private:
+	std::ofstream file;
+	std::string cacheFilePath;
+	std::string tempFilePath;
+
+	uint64_t numExpectedGaussians;
+	uint64_t numWrittenGaussians;
+
+public:
+	GaussianCacheWriter();
+	~GaussianCacheWriter();
+
+	bool begin(
+		const std::string& cacheFilePath, 
+		const std::string& sourceFilePath, 
+		uint32_t gaussianOrdering, 
+		uint32_t shDegree, 
+		size_t numGaussians);
+	void write(const GaussianData* gaussianData, size_t numGaussians);
+
+	// Replaces the cache file if all gaussians were successfully written
+	bool end();
+
+	inline bool isWriting() const { return this->file.is_open(); }
+};
\ No newline at end of file
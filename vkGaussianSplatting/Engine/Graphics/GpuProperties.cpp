@@ -6,6 +6,12 @@
 VkPhysicalDevice* GpuProperties::physicalDevice = nullptr;
 float GpuProperties::maxAnisotropy = 0.0f;
 float GpuProperties::timestampPeriod = 0.0f;
+uint32_t GpuProperties::vendorID = 0;
+uint32_t GpuProperties::deviceID = 0;
+uint32_t GpuProperties::driverVersion = 0;
+std::string GpuProperties::deviceName = "";
+uint32_t GpuProperties::maxComputeWorkGroupInvocations = 0;
+uint32_t GpuProperties::maxComputeSharedMemorySize = 0;
 uint32_t GpuProperties::memoryTypeCount = 0;
 VkMemoryType GpuProperties::memoryTypes[32]{};
 
@@ -34,6 +40,14 @@ void GpuProperties::updateProperties(
 	GpuProperties::maxAnisotropy = properties.limits.maxSamplerAnisotropy;
 	GpuProperties::timestampPeriod = properties.limits.timestampPeriod;
 
+	// Identify the device and driver, for cached sort tuning
+	GpuProperties::vendorID = properties.vendorID;
+	GpuProperties::deviceID = properties.deviceID;
+	GpuProperties::driverVersion = properties.driverVersion;
+	GpuProperties::deviceName = std::string(properties.deviceName);
+	GpuProperties::maxComputeWorkGroupInvocations = properties.limits.maxComputeWorkGroupInvocations;
+	GpuProperties::maxComputeSharedMemorySize = properties.limits.maxComputeSharedMemorySize;
+
 	// Memory properties
 	GpuProperties::memoryTypeCount = memProperties.memoryTypeCount;
 	for (uint32_t i = 0; i < GpuProperties::memoryTypeCount; ++i)
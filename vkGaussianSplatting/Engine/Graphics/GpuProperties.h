@@ -31,6 +31,13 @@ private:
 	static float maxAnisotropy;
 	static float timestampPeriod;
 
+	static uint32_t vendorID;
+	static uint32_t deviceID;
+	static uint32_t driverVersion;
+	static std::string deviceName;
+	static uint32_t maxComputeWorkGroupInvocations;
+	static uint32_t maxComputeSharedMemorySize;
+
 	static uint32_t memoryTypeCount;
 	static VkMemoryType memoryTypes[32];
 
@@ -57,6 +64,13 @@ public:
 	static inline float getMaxAnisotropy() { return maxAnisotropy; }
 	static inline float getTimestampPeriod() { return timestampPeriod; }
 
+	static inline uint32_t getVendorID() { return vendorID; }
+	static inline uint32_t getDeviceID() { return deviceID; }
+	static inline uint32_t getDriverVersion() { return driverVersion; }
+	static inline const std::string& getDeviceName() { return deviceName; }
+	static inline uint32_t getMaxComputeWorkGroupInvocations() { return maxComputeWorkGroupInvocations; }
+	static inline uint32_t getMaxComputeSharedMemorySize() { return maxComputeSharedMemorySize; }
+
 	static const inline uint32_t& getMemoryTypeCount() { return memoryTypeCount; }
 	static const inline VkMemoryType& getMemoryType(const uint32_t& index) { return memoryTypes[index]; }
 
@@ -0,0 +1,263 @@
+#include "pch.h"
+#include <sstream>
+#include <string_view>
+#include "PlyReader.h"
+
+bool PlyReader::getPropertyType(const std::string& typeStr, PlyPropertyType& outputType)
+{
+	if (typeStr == "char" || typeStr == "int8")
+		outputType = PlyPropertyType::INT8;
+	else if (typeStr == "uchar" || typeStr == "uint8")
+		outputType = PlyPropertyType::UINT8;
+	else if (typeStr == "short" || typeStr == "int16")
+		outputType = PlyPropertyType::INT16;
+	else if (typeStr == "ushort" || typeStr == "uint16")
+		outputType = PlyPropertyType::UINT16;
+	else if (typeStr == "int" || typeStr == "int32")
+		outputType = PlyPropertyType::INT32;
+	else if (typeStr == "uint" || typeStr == "uint32")
+		outputType = PlyPropertyType::UINT32;
+	else if (typeStr == "float" || typeStr == "float32")
+		outputType = PlyPropertyType::FLOAT32;
+	else if (typeStr == "double" || typeStr == "float64")
+		outputType = PlyPropertyType::FLOAT64;
+	else
+		return false;
+
+	return true;
+}
+
+uint32_t PlyReader::getPropertyTypeSize(PlyPropertyType type)
+{
+	switch (type)
+	{
+	case PlyPropertyType::INT8:
+	case PlyPropertyType::UINT8:
+		return 1;
+
+	case PlyPropertyType::INT16:
+	case PlyPropertyType::UINT16:
+		return 2;
+
+	case PlyPropertyType::INT32:
+	case PlyPropertyType::UINT32:
+	case PlyPropertyType::FLOAT32:
+		return 4;
+
+	case PlyPropertyType::FLOAT64:
+		return 8;
+	}
+
+	return 0;
+}
+
+bool PlyReader::parseHeader(const std::string& filePath)
+{
+	const char* fileData = (const char*) this->file.getData();
+	const size_t fileSize = this->file.getSize();
+
+	// Find end of header
+	const std::string endHeaderStr = "end_header";
+	const std::string_view fileView(fileData, fileSize);
+	size_t endHeaderPos = fileView.find(endHeaderStr);
+	if (fileView.substr(0, 3) != "ply" || endHeaderPos == std::string_view::npos)
+	{
+		Log::error("File is not a valid .ply file: " + filePath);
+		return false;
+	}
+	size_t headerSize = fileView.find('\n', endHeaderPos);
+	if (headerSize == std::string_view::npos)
+	{
+		Log::error("Header of .ply file is not terminated: " + filePath);
+		return false;
+	}
+	headerSize++;
+
+	// Parse header line by line
+	std::istringstream headerStream(std::string(fileData, headerSize));
+	std::string line;
+	bool isBinaryLittleEndian = false;
+	bool isInVertexElement = false;
+	bool foundVertexElement = false;
+	bool precedingElementHasList = false;
+	size_t precedingElementCount = 0;
+	uint32_t precedingElementStride = 0;
+	size_t vertexDataOffset = headerSize;
+	while (std::getline(headerStream, line))
+	{
+		// Handle CRLF line endings
+		if (line.size() > 0 && line.back() == '\r')
+			line.pop_back();
+
+		std::istringstream lineStream(line);
+		std::string keyword;
+		lineStream >> keyword;
+
+		if (keyword == "format")
+		{
+			std::string formatStr;
+			lineStream >> formatStr;
+			isBinaryLittleEndian = formatStr == "binary_little_endian";
+		}
+		else if (keyword == "element")
+		{
+			// Skip data of the element before this one
+			if (!foundVertexElement)
+			{
+				if (precedingElementHasList && precedingElementCount > 0)
+				{
+					Log::error("Elements with list properties can not precede vertices in .ply file: " + filePath);
+					return false;
+				}
+				vertexDataOffset += precedingElementCount * precedingElementStride;
+			}
+
+			std::string elementName;
+			size_t elementCount = 0;
+			lineStream >> elementName >> elementCount;
+
+			isInVertexElement = elementName == "vertex" && !foundVertexElement;
+			if (isInVertexElement)
+			{
+				foundVertexElement = true;
+				this->numVertices = elementCount;
+			}
+			else if (!foundVertexElement)
+			{
+				precedingElementHasList = false;
+				precedingElementCount = elementCount;
+				precedingElementStride = 0;
+			}
+		}
+		else if (keyword == "property")
+		{
+			std::string typeStr;
+			lineStream >> typeStr;
+
+			if (typeStr == "list")
+			{
+				if (isInVertexElement)
+				{
+					Log::error("List properties on vertices are not supported in .ply file: " + filePath);
+					return false;
+				}
+
+				precedingElementHasList = true;
+				continue;
+			}
+
+			PlyPropertyType type;
+			if (!PlyReader::getPropertyType(typeStr, type))
+			{
+				Log::error("Unknown property type \"" + typeStr + "\" in .ply file: " + filePath);
+				return false;
+			}
+
+			if (isInVertexElement)
+			{
+				PlyProperty property{};
+				lineStream >> property.name;
+				property.type = type;
+				property.offset = this->vertexStride;
+				this->vertexProperties.push_back(property);
+
+				this->vertexStride += PlyReader::getPropertyTypeSize(type);
+			}
+			else if (!foundVertexElement)
+			{
+				precedingElementStride += PlyReader::getPropertyTypeSize(type);
+			}
+		}
+		else if (keyword == "end_header")
+		{
+			break;
+		}
+	}
+
+	if (!isBinaryLittleEndian)
+	{
+		Log::error("Only binary_little_endian .ply files are supported: " + filePath);
+		return false;
+	}
+	if (!foundVertexElement || this->vertexStride == 0)
+	{
+		Log::error("No vertex element found in .ply file: " + filePath);
+		return false;
+	}
+
+	// Make sure all vertex records are within the file
+	if (vertexDataOffset + this->numVertices * this->vertexStride > fileSize)
+	{
+		Log::error("Vertex data is truncated in .ply file: " + filePath);
+		return false;
+	}
+
+	this->vertexData = this->file.getData() + vertexDataOffset;
+
+	return true;
+}
+
+PlyReader::PlyReader()
+	: vertexData(nullptr),
+	numVertices(0),
+	vertexStride(0)
+{
+}
+
+PlyReader::~PlyReader()
+{
+	this->close();
+}
+
+bool PlyReader::open(const std::string& filePath)
+{
+	this->close();
+
+	if (!this->file.map(filePath))
+		return false;
+
+	if (!this->parseHeader(filePath))
+	{
+		this->close();
+		return false;
+	}
+
+	return true;
+}
+
+void PlyReader::close()
+{
+	this->file.unmap();
+	this->vertexProperties.clear();
+	this->vertexData = nullptr;
+	this->numVertices = 0;
+	this->vertexStride = 0;
+}
+
+bool PlyReader::getFloatPropertyOffset(const std::string& propertyName, uint32_t& outputOffset) const
+{
+	for (size_t i = 0; i < this->vertexProperties.size(); ++i)
+	{
+		if (this->vertexProperties[i].name == propertyName)
+		{
+			if (this->vertexProperties[i].type != PlyPropertyType::FLOAT32)
+				return false;
+
+			outputOffset = this->vertexProperties[i].offset;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool PlyReader::hasProperty(const std::string& propertyName) const
+{
+	for (size_t i = 0; i < this->vertexProperties.size(); ++i)
+	{
+		if (this->vertexProperties[i].name == propertyName)
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../Dev/MappedFile.h"
+
+enum class PlyPropertyType : uint32_t
+{
+	INT8 = 0,
+	UINT8 = 1,
+	INT16 = 2,
+	UINT16 = 3,
+	INT32 = 4,
+	UINT32 = 5,
+	FLOAT32 = 6,
+	FLOAT64 = 7
+};
+
+struct PlyProperty
+{
+	std::string name;
+	PlyPropertyType type;
+	uint32_t offset; // Byte offset within one vertex record
+};
+
+// Reader for binary little endian .ply files. The file is memory mapped and
+// the header is parsed once, after which vertex records can be decoded
+// directly from the mapped memory without intermediate per-property copies.
+class PlyReader
+{
+private:
+	MappedFile file;
+
+	std::vector<PlyProperty> vertexProperties;
+
+	const uint8_t* vertexData;
+	size_t numVertices;
+	uint32_t vertexStride;
+
+	bool parseHeader(const std::string& filePath);
+
+	static bool getPropertyType(const std::string& typeStr, PlyPropertyType& outputType);
+	static uint32_t getPropertyTypeSize(PlyPropertyType type);
+
+public:
+	PlyReader();
+	~PlyReader();
+
+	bool open(const std::string& filePath);
+	void close();
+
+	bool getFloatPropertyOffset(const std::string& propertyName, uint32_t& outputOffset) const;
+	bool hasProperty(const std::string& propertyName) const;
+
+	inline static float readFloat(const uint8_t* vertexRecord, uint32_t offset)
+	{
+		float value;
+		std::memcpy(&value, vertexRecord + offset, sizeof(float));
+		return value;
+	}
+
+	inline const uint8_t* getVertexRecord(size_t index) const { return this->vertexData + index * this->vertexStride; }
+	inline const std::vector<PlyProperty>& getVertexProperties() const { return this->vertexProperties; }
+	inline size_t getNumVertices() const { return this->numVertices; }
+	inline uint32_t getVertexStride() const { return this->vertexStride; }
+	inline size_t getFileSize() const { return this->file.getSize(); }
+	inline bool isOpen() const { return this->vertexData != nullptr; }
+};
\ No newline at end of file
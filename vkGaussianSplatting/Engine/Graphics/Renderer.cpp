@@ -2,8 +2,7 @@
 #include "Renderer.h"
 #include "../ResourceManager.h"
 #include "../Dev/StrHelper.h"
-#include "Sort/BitonicMergeSort.h"
-#include "Sort/RadixSort.h"
+#include "Sort/GpuSortTuner.h"
 
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
@@ -86,6 +85,11 @@ void Renderer::initVulkan()
 		{
 			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
@@ -93,19 +97,110 @@ void Renderer::initVulkan()
 		VK_SHADER_STAGE_COMPUTE_BIT,
 		sizeof(InitSortListPCD)
 	);
-	this->initSortListPipeline.createComputePipeline(
+#ifdef COMPARE_SPLAT_EXTENTS
+	const uint32_t compareSplatExtents = 1;
+#else
+	const uint32_t compareSplatExtents = 0;
+#endif
+	for (uint32_t shDegree = 0; shDegree <= GaussianShData::MAX_DEGREE; ++shDegree)
+	{
+		// Only the coefficients of the degree are loaded and evaluated
+		this->initSortListPipelines[shDegree].createComputePipeline(
+			this->device,
+			this->initSortListPipelineLayout,
+			"Resources/Shaders/InitSortList.comp.spv",
+			{
+				SpecializationConstant{ (void*) this->resourceManager->getShStorageMode(), sizeof(uint32_t) },
+				SpecializationConstant{ (void*) shDegree, sizeof(uint32_t) },
+				SpecializationConstant{ (void*) compareSplatExtents, sizeof(uint32_t) }
+			}
+		);
+	}
+
+	// Two-phase init sort list compute pipelines
+	this->initSortListReducePipelineLayout.createPipelineLayout(
+		this->device,
+		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
+		},
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		sizeof(InitSortListScanPCD)
+	);
+	this->initSortListReducePipeline.createComputePipeline(
+		this->device,
+		this->initSortListReducePipelineLayout,
+		"Resources/Shaders/InitSortListReduce.comp.spv"
+	);
+	this->initSortListScanPipelineLayout.createPipelineLayout(
+		this->device,
+		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
+		},
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		sizeof(InitSortListScanPCD)
+	);
+	this->initSortListScanPipeline.createComputePipeline(
+		this->device,
+		this->initSortListScanPipelineLayout,
+		"Resources/Shaders/InitSortListScan.comp.spv"
+	);
+	this->initSortListWritePipelineLayout.createPipelineLayout(
+		this->device,
+		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
+		},
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		sizeof(InitSortListScanPCD)
+	);
+	this->initSortListWritePipeline.createComputePipeline(
 		this->device,
-		this->initSortListPipelineLayout,
-		"Resources/Shaders/InitSortList.comp.spv"
+		this->initSortListWritePipelineLayout,
+		"Resources/Shaders/InitSortListWrite.comp.spv"
 	);
 
 	// Init resources specific to a gpu sorting algorithm
+#ifdef AUTOTUNE_GPU_SORT
+	this->gpuSort = GpuSortFactory::create(
+		GpuSortTuner::getConfig(this->gfxAllocContext, this->getNumTiles(), this->getNumCompactTileBits())
+	);
+#else
+	GpuSortConfig gpuSortConfig{};
+	gpuSortConfig.sortAlgorithm = GPU_SORT_ALGORITHM;
+	this->gpuSort = GpuSortFactory::create(gpuSortConfig);
+#endif
 	this->gpuSort->singleInitResources(this->gfxAllocContext);
 
+	// Find ranges compute pipeline (indirect setup)
+	this->findRangesIndirectSetupPipelineLayout.createPipelineLayout(
+		this->device,
+		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
+		},
+		VK_SHADER_STAGE_COMPUTE_BIT
+	);
+	this->findRangesIndirectSetupPipeline.createComputePipeline(
+		this->device,
+		this->findRangesIndirectSetupPipelineLayout,
+		"Resources/Shaders/FindRangesIndirectSetup.comp.spv",
+		{
+			SpecializationConstant{ (void*) FIND_RANGES_GROUP_SIZE, sizeof(uint32_t) }
+		}
+	);
+
 	// Find ranges compute pipeline
 	this->findRangesPipelineLayout.createPipelineLayout(
 		this->device,
 		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
 		},
@@ -126,8 +221,6 @@ void Renderer::initVulkan()
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 
-			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
-
 			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT }
 		},
 		VK_SHADER_STAGE_COMPUTE_BIT,
@@ -141,6 +234,12 @@ void Renderer::initVulkan()
 
 	this->createSyncObjects();
 	this->createCamUbo();
+
+	// Requested number of sort elements
+	this->sortCountReadback.createReadbackBuffer(
+		this->gfxAllocContext,
+		sizeof(GaussianCullData::numGaussiansToRender)
+	);
 }
 
 void Renderer::initVma()
@@ -233,13 +332,13 @@ void Renderer::cleanup()
 
 	this->swapchain.cleanup();
 
+	this->cleanupForScene();
 	this->gpuSort->cleanup();
 
-	this->gaussiansSortListSBO->cleanup();
-	this->gaussiansTileRangesSBO.cleanup();
-	this->gaussiansCullDataSBO.cleanup();
-	this->gaussiansSBO.cleanup();
+	this->loadedGaussiansGeometrySBO.cleanup();
+	this->loadedGaussiansShSBO.cleanup();
 	this->camUBO.cleanup();
+	this->sortCountReadback.cleanup();
 
 	this->imageAvailableSemaphores.cleanup();
 	this->renderGaussiansFinishedSemaphores.cleanup();
@@ -255,8 +354,18 @@ void Renderer::cleanup()
 	this->renderGaussiansPipelineLayout.cleanup();
 	this->findRangesPipeline.cleanup();
 	this->findRangesPipelineLayout.cleanup();
-
-	this->initSortListPipeline.cleanup();
+	this->findRangesIndirectSetupPipeline.cleanup();
+	this->findRangesIndirectSetupPipelineLayout.cleanup();
+
+	this->initSortListWritePipeline.cleanup();
+	this->initSortListWritePipelineLayout.cleanup();
+	this->initSortListScanPipeline.cleanup();
+	this->initSortListScanPipelineLayout.cleanup();
+	this->initSortListReducePipeline.cleanup();
+	this->initSortListReducePipelineLayout.cleanup();
+
+	for (size_t i = 0; i < this->initSortListPipelines.size(); ++i)
+		this->initSortListPipelines[i].cleanup();
 	this->initSortListPipelineLayout.cleanup();
 	
 	vmaDestroyAllocator(this->vmaAllocator);
@@ -296,6 +405,9 @@ void Renderer::createSyncObjects()
 
 void Renderer::draw(Scene& scene)
 {
+	// Render the gaussians uploaded so far, if the scene is loading progressively
+	this->updateNumResidentGaussians();
+
 #ifdef RECORD_CPU_TIMES
 	Time::startTimer();
 #endif
@@ -313,6 +425,13 @@ void Renderer::draw(Scene& scene)
 	float waitForFencesMs = Time::endTimer() * 1000.0f;
 #endif
 
+	// The frame previously using this index has finished, 
+	// so its requested number of sort elements can be read
+#ifdef VALIDATE_GPU_SORT
+	this->sortValidator.validatePendingFrame(GfxState::getFrameIndex());
+#endif
+	this->updateSortListCapacity();
+
 	// Get next image index from the swapchain
 	uint32_t imageIndex;
 	VkResult result = vkAcquireNextImageKHR(
@@ -351,6 +470,9 @@ void Renderer::draw(Scene& scene)
 	float recordCommandBufferMs = Time::endTimer() * 1000.0f;
 #endif
 
+	// Queues are shared with scenes loading in the background
+	std::unique_lock<std::mutex> queueLock(this->queueFamilies.getQueueMutex());
+
 	// Update and Render additional Platform Windows
 	if (this->imguiIO->ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 	{
@@ -402,6 +524,7 @@ void Renderer::draw(Scene& scene)
 
 	// Present
 	result = vkQueuePresentKHR(this->queueFamilies.getVkPresentQueue(), &presentInfo);
+	queueLock.unlock();
 
 #ifdef RECORD_CPU_TIMES
 	float presentMs = Time::endTimer() * 1000.0f;
@@ -456,7 +579,9 @@ void Renderer::draw(Scene& scene)
 #endif 
 
 #ifdef RECORD_GPU_TIMES
+	queueLock.lock();
 	this->device.waitIdle();
+	queueLock.unlock();
 	this->queryPools.getQueryPoolResults(GfxState::getFrameIndex());
 
 	// Gather this frame's data
@@ -505,7 +630,22 @@ void Renderer::draw(Scene& scene)
 			"sort ms: " + StrHelper::toTimingStr(this->avgSortMs) + "\n" +
 			"find ranges ms: " + StrHelper::toTimingStr(this->avgFindRangesMs) + "\n" +
 			"render gaussians ms: " + StrHelper::toTimingStr(this->avgRenderGaussiansMs) + "\n" +
-			"total gpu time ms: " + StrHelper::toTimingStr(this->avgTotalGpuTimeMs));
+			"total gpu time ms: " + StrHelper::toTimingStr(this->avgTotalGpuTimeMs) + "\n" +
+			"sort list overflow frames: " + std::to_string(this->numSortOverflowFrames));
+	}
+#endif
+
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+	if (this->elapsedFrames >= this->WAIT_ELAPSED_WARMUP_FRAMES_FOR_AVG + this->WAIT_ELAPSED_FRAMES_FOR_AVG - 0.5f)
+	{
+		this->benchmarkNextGaussianOrdering();
+	}
+#endif
+
+#ifdef BENCHMARK_INIT_SORT_LIST
+	if (this->elapsedFrames >= this->WAIT_ELAPSED_WARMUP_FRAMES_FOR_AVG + this->WAIT_ELAPSED_FRAMES_FOR_AVG - 0.5f)
+	{
+		this->benchmarkNextInitSortList();
 	}
 #endif
 #endif
@@ -514,6 +654,107 @@ void Renderer::draw(Scene& scene)
 	GfxState::currentFrameIndex = (GfxState::currentFrameIndex + 1) % GfxSettings::FRAMES_IN_FLIGHT;
 }
 
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+static const std::array<GaussianOrdering, 3> BENCHMARK_ORDERINGS =
+{
+	GaussianOrdering::MORTON_32,
+	GaussianOrdering::MORTON_64,
+	GaussianOrdering::HILBERT
+};
+
+void Renderer::benchmarkNextGaussianOrdering()
+{
+	// All orderings have already been measured
+	if (this->benchmarkOrderingIndex >= BENCHMARK_ORDERINGS.size())
+		return;
+
+	// Results for the current ordering
+	this->benchmarkOrderingResults += 
+		std::string(ResourceManager::getGaussianOrderingName(this->resourceManager->getGaussianOrdering())) + "\n" +
+		"    init sort list ms: " + StrHelper::toTimingStr(this->avgInitSortListMs) + "\n" +
+		"    render gaussians ms: " + StrHelper::toTimingStr(this->avgRenderGaussiansMs) + "\n" +
+		"    total gpu time ms: " + StrHelper::toTimingStr(this->avgTotalGpuTimeMs) + "\n";
+
+	this->benchmarkOrderingIndex++;
+	if (this->benchmarkOrderingIndex >= BENCHMARK_ORDERINGS.size())
+	{
+		Log::writeAlert(this->benchmarkOrderingResults);
+		return;
+	}
+
+	// Reorder and reupload gaussians for the next measurement
+	{
+		std::lock_guard<std::mutex> queueLock(this->queueFamilies.getQueueMutex());
+		this->device.waitIdle();
+	}
+	this->resourceManager->reorderGaussians(BENCHMARK_ORDERINGS[this->benchmarkOrderingIndex]);
+
+	this->gaussiansGeometrySBO.cleanup();
+	this->gaussiansShSBO.cleanup();
+	this->gaussiansGeometrySBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(GaussianGeometryData) * this->resourceManager->getNumGaussians(),
+		nullptr
+	);
+	this->gaussiansShSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		ShCompression::getStreamSize(
+			this->resourceManager->getShStorageMode(), 
+			this->resourceManager->getGaussianShDegree(), 
+			this->resourceManager->getNumGaussians()
+		),
+		nullptr
+	);
+	this->resourceManager->uploadGaussians(
+		this->gaussiansGeometrySBO.getVkBuffer(), 
+		this->gaussiansShSBO.getVkBuffer()
+	);
+
+	// Restart averages
+	this->elapsedFrames = 0.0f;
+	this->avgInitSortListMs = 0.0f;
+	this->avgSortMs = 0.0f;
+	this->avgFindRangesMs = 0.0f;
+	this->avgRenderGaussiansMs = 0.0f;
+	this->avgTotalGpuTimeMs = 0.0f;
+}
+#endif
+
+#ifdef BENCHMARK_INIT_SORT_LIST
+void Renderer::benchmarkNextInitSortList()
+{
+	// Both paths have already been measured
+	if (this->benchmarkInitSortListIndex >= 2)
+		return;
+
+	// Results for the current path. The sort is included, 
+	// since the order of the elements affects its locality.
+	this->benchmarkInitSortListResults += 
+		std::string(this->usesTwoPhaseInitSortList() ? "Two-phase" : "Atomic") + " init sort list\n" +
+		"    init sort list ms: " + StrHelper::toTimingStr(this->avgInitSortListMs) + "\n" +
+		"    sort ms: " + StrHelper::toTimingStr(this->avgSortMs) + "\n" +
+		"    total gpu time ms: " + StrHelper::toTimingStr(this->avgTotalGpuTimeMs) + "\n";
+
+	this->benchmarkInitSortListIndex++;
+	if (this->benchmarkInitSortListIndex >= 2)
+	{
+		Log::writeAlert(this->benchmarkInitSortListResults);
+		return;
+	}
+
+	// Measure the other path next
+	this->twoPhaseInitSortList = !this->twoPhaseInitSortList;
+
+	// Restart averages
+	this->elapsedFrames = 0.0f;
+	this->avgInitSortListMs = 0.0f;
+	this->avgSortMs = 0.0f;
+	this->avgFindRangesMs = 0.0f;
+	this->avgRenderGaussiansMs = 0.0f;
+	this->avgTotalGpuTimeMs = 0.0f;
+}
+#endif
+
 void Renderer::generateMemoryDump()
 {
 	Log::alert("Generated memory dump called \"VmaDump.json\"");
@@ -579,11 +820,28 @@ void Renderer::recordCommandBuffer(
 	);
 #endif
 
+#ifdef VALIDATE_GPU_SORT
+	const bool validateSort = this->sortValidator.beginFrame(GfxState::getFrameIndex());
+	if (validateSort)
+		this->sortValidator.recordUnsortedCopy(commandBuffer, *this->gaussiansSortListSBO);
+#endif
+
 	this->gpuSort->computeSort(
 		commandBuffer, 
 		this->gaussiansCullDataSBO, 
 		this->gaussiansSortListSBO);
 
+#ifdef VALIDATE_GPU_SORT
+	if (validateSort)
+	{
+		this->sortValidator.recordSortedCopy(
+			commandBuffer, 
+			*this->gaussiansSortListSBO, 
+			this->gaussiansCullDataSBO
+		);
+	}
+#endif
+
 #ifdef RECORD_GPU_TIMES
 	commandBuffer.writeTimestamp(
 		this->queryPools[GfxState::getFrameIndex()],
@@ -592,9 +850,13 @@ void Renderer::recordCommandBuffer(
 	);
 #endif
 
-	this->computeRanges(
-		commandBuffer
-	);
+	// The sort might already have written the ranges
+	if (!this->gpuSort->writesTileRanges())
+	{
+		this->computeRanges(
+			commandBuffer
+		);
+	}
 
 #ifdef RECORD_GPU_TIMES
 	commandBuffer.writeTimestamp(
@@ -622,6 +884,8 @@ void Renderer::recordCommandBuffer(
 	);
 #endif
 
+	this->recordSortCountReadback(commandBuffer);
+
 	//this->renderImgui(commandBuffer, imguiDrawData);
 
 	// Stop recording
@@ -661,6 +925,14 @@ Renderer::Renderer()
 	avgTotalGpuTimeMs(0.0f),
 #endif
 
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+	benchmarkOrderingIndex(0),
+#endif
+
+#ifdef BENCHMARK_INIT_SORT_LIST
+	benchmarkInitSortListIndex(0),
+#endif
+
 #ifdef RECORD_CPU_TIMES
 	elapsedFrames(0.0f),
 	avgWaitForFenceMs(0.0f),
@@ -669,15 +941,26 @@ Renderer::Renderer()
 	avgCpuFrameTimeMs(0.0f),
 #endif
 
-#if GPU_SORT_ALGORITHM == BITONIC_MERGE_SORT
-	gpuSort(std::make_shared<BitonicMergeSort>()),
-#elif GPU_SORT_ALGORITHM == RADIX_SORT
-	gpuSort(std::make_shared<RadixSort>()),
-#endif
-
 	vmaAllocator(nullptr),
+	numLoadedGaussians(0),
+	loadedShDegree(GaussianShData::MAX_DEGREE),
+	numUploadedGaussians(0),
+	numSceneGaussians(0),
+	sceneShDegree(GaussianShData::MAX_DEGREE),
 	numGaussians(0),
-	numSortElements(0)
+	numSortElements(0),
+	sortCountReadbackWritten{},
+	numFramesBelowShrinkThreshold(0),
+	maxRequestedSortElementsBelowThreshold(0),
+	numSortOverflowFrames(0),
+#ifdef COMPARE_SPLAT_EXTENTS
+	numFramesUntilSplatExtentsLog(0),
+#endif
+#ifdef TWO_PHASE_INIT_SORT_LIST
+	twoPhaseInitSortList(true)
+#else
+	twoPhaseInitSortList(false)
+#endif
 {
 }
 
@@ -693,11 +976,79 @@ void Renderer::init(ResourceManager& resourceManager)
 	this->initImgui();
 }
 
+glm::uvec2 Renderer::getTileGridSize() const
+{
+	return glm::uvec2(
+		(this->swapchain.getVkExtent().width + TILE_SIZE - 1) / TILE_SIZE,
+		(this->swapchain.getVkExtent().height + TILE_SIZE - 1) / TILE_SIZE
+	);
+}
+
 uint32_t Renderer::getNumTiles() const
 {
-	return 
-		((this->swapchain.getVkExtent().width + TILE_SIZE - 1) / TILE_SIZE) *
-		((this->swapchain.getVkExtent().height + TILE_SIZE - 1) / TILE_SIZE);
+	const glm::uvec2 tileGridSize = this->getTileGridSize();
+	return tileGridSize.x * tileGridSize.y;
+}
+
+uint32_t Renderer::getNumTileBits() const
+{
+	return std::max(this->getMinNumBits(this->getNumTiles() - 1), 1u);
+}
+
+uint32_t Renderer::getNumCompactTileBits() const
+{
+#ifdef COMPACT_SORT_KEYS
+	return this->getNumTileBits();
+#else
+	return 0;
+#endif
+}
+
+uint32_t Renderer::getNumInitListScanBlocks(uint32_t numGaussians) const
+{
+	return (numGaussians + INIT_LIST_SCAN_BLOCK_SIZE - 1) / INIT_LIST_SCAN_BLOCK_SIZE;
+}
+
+bool Renderer::usesTwoPhaseInitSortList() const
+{
+	// Tile rects are packed into 8 bits per side
+	const glm::uvec2 tileGridSize = this->getTileGridSize();
+	return this->twoPhaseInitSortList && tileGridSize.x <= 255 && tileGridSize.y <= 255;
+}
+
+uint32_t Renderer::getNumSortKeyBits() const
+{
+	// Not all of the highest bits in the sorting keys are utilized, 
+	// meaning that sorting only needs to be done for the lowest bits actually being used.
+#ifdef COMPACT_SORT_KEYS
+	return 32;
+#else
+	return 32 + this->getNumTileBits();
+#endif
+}
+
+uint32_t Renderer::getMinNumBits(uint32_t x) const
+{
+	for (int32_t i = 32 - 1; i >= 0; --i)
+	{
+		if (uint32_t(x >> i) & 1)
+			return static_cast<uint32_t>(i + 1);
+	}
+
+	return 0;
+}
+
+uint32_t Renderer::getNumSortElements(uint32_t numResidentGaussians) const
+{
+	return this->getCeilPowTwo(numResidentGaussians + 64 * 16 * this->getNumTiles());
+}
+
+uint32_t Renderer::getSortListCapacity(uint32_t numRequestedSortElements) const
+{
+	uint64_t numWithMargin = uint64_t(numRequestedSortElements) * SORT_LIST_MARGIN_PERCENT / 100;
+	numWithMargin = std::min(numWithMargin, uint64_t(1u << 31));
+
+	return std::max(this->getCeilPowTwo(uint32_t(numWithMargin)), MIN_SORT_ELEMENTS);
 }
 
 uint32_t Renderer::getCeilPowTwo(uint32_t x) const
@@ -709,28 +1060,141 @@ uint32_t Renderer::getCeilPowTwo(uint32_t x) const
 	return num;
 }
 
+void Renderer::loadGaussiansForScene(const std::function<void(float)>& progressCallback)
+{
+	// Runs on the scene loading thread, so nothing used by 
+	// frames in flight can be touched here
+
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+	// Start with the first ordering to measure
+	this->resourceManager->reorderGaussians(BENCHMARK_ORDERINGS[0]);
+#endif
+
+	this->numLoadedGaussians = (uint32_t) this->resourceManager->getNumGaussians();
+	this->loadedShDegree = this->resourceManager->getGaussianShDegree();
+	this->numUploadedGaussians = 0;
+
+	// Gaussian geometry and SH SBOs, streamed from the resource manager in chunks
+	this->loadedGaussiansGeometrySBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(GaussianGeometryData) * this->numLoadedGaussians,
+		nullptr
+	);
+	this->loadedGaussiansShSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		ShCompression::getStreamSize(this->resourceManager->getShStorageMode(), this->loadedShDegree, this->numLoadedGaussians),
+		nullptr
+	);
+
+	// When loading progressively, the buffer might already be rendered from 
+	// at this point. The copies are submitted before the uploaded count is 
+	// increased, so frames submitted afterwards will see the new gaussians.
+	const VkBuffer geometryBuffer = this->loadedGaussiansGeometrySBO.getVkBuffer();
+	const VkBuffer shBuffer = this->loadedGaussiansShSBO.getVkBuffer();
+	const uint32_t numGaussiansToUpload = this->numLoadedGaussians;
+	this->resourceManager->uploadGaussians(
+		geometryBuffer, 
+		shBuffer, 
+		[&](size_t numUploaded)
+		{
+			this->numUploadedGaussians = (uint32_t) numUploaded;
+			if (progressCallback)
+				progressCallback(float(numUploaded) / float(numGaussiansToUpload));
+		}
+	);
+}
+
 void Renderer::initForScene(Scene& scene)
 {
-	// Retrieve gaussians from resource manager
-	const std::vector<GaussianData>& gaussiansData = 
-		this->resourceManager->getGaussians();
+	// Resources of the previous scene might still be used by frames in flight
+	{
+		std::lock_guard<std::mutex> queueLock(this->queueFamilies.getQueueMutex());
+		this->device.waitIdle();
+	}
+	this->cleanupForScene();
+
+	// Swap in the gaussians uploaded by loadGaussiansForScene(). 
+	// They might only be partly resident when loading progressively.
+	this->gaussiansGeometrySBO = this->loadedGaussiansGeometrySBO;
+	this->gaussiansShSBO = this->loadedGaussiansShSBO;
+	this->loadedGaussiansGeometrySBO = StorageBuffer();
+	this->loadedGaussiansShSBO = StorageBuffer();
+	this->numSceneGaussians = this->numLoadedGaussians;
+	this->sceneShDegree = this->loadedShDegree;
+	this->numGaussians = std::min(this->numUploadedGaussians.load(), this->numSceneGaussians);
+	this->numLoadedGaussians = 0;
+
+	// Projected gaussians, written by InitSortList for every gaussian in the sort list
+	this->gaussiansSplatSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(GaussianSplatData) * this->numSceneGaussians,
+		nullptr
+	);
 
-	// Gaussians SBO
-	this->gaussiansSBO.createGpuBuffer(
+	// Range data
+	const std::vector<GaussianTileRangeData> dummyRangeData(this->getNumTiles());
+	this->gaussiansTileRangesSBO.createGpuBuffer(
 		this->gfxAllocContext,
-		sizeof(gaussiansData[0]) * gaussiansData.size(),
-		gaussiansData.data()
+		sizeof(dummyRangeData[0]) * dummyRangeData.size(),
+		dummyRangeData.data()
 	);
-	this->numGaussians = (uint32_t) gaussiansData.size();
-	this->numSortElements = this->getCeilPowTwo(this->numGaussians + 64 * 16 * this->getNumTiles());
 
-	// Gaussians list SBO for sorting
-	std::vector<GaussianSortData> sortData(this->numSortElements); // Dummy data
+	// Tile rect and depth key of each gaussian, written by the first pass of the 
+	// two-phase InitSortList. Binding it to InitSortList still requires a buffer.
+	uint32_t numTileRects = 1;
+#if defined(TWO_PHASE_INIT_SORT_LIST) || defined(BENCHMARK_INIT_SORT_LIST)
+	numTileRects = std::max(this->numSceneGaussians, 1u);
+#endif
+	this->initSortListTileRectsSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(GaussianTileRectData) * numTileRects,
+		nullptr
+	);
+
+	// Element count of each gaussian, written by the first pass of the two-phase InitSortList. 
+	// Binding it to InitSortList still requires a buffer.
+	uint32_t numElementCounts = 1;
+#if defined(TWO_PHASE_INIT_SORT_LIST) || defined(BENCHMARK_INIT_SORT_LIST)
+	numElementCounts = std::max(this->numSceneGaussians, 1u);
+#endif
+	this->initSortListCountsSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(uint32_t) * numElementCounts,
+		nullptr
+	);
+
+	// Element count, and then offset, of each block of gaussians in the two-phase InitSortList
+	this->initSortListBlockSumsSBO.createGpuBuffer(
+		this->gfxAllocContext,
+		sizeof(uint32_t) * std::max(this->getNumInitListScanBlocks(this->numSceneGaussians), 1u),
+		nullptr
+	);
+	if (this->twoPhaseInitSortList && !this->usesTwoPhaseInitSortList())
+	{
+		const glm::uvec2 tileGridSize = this->getTileGridSize();
+		Log::warning(
+			"The tile grid (" + std::to_string(tileGridSize.x) + "x" + std::to_string(tileGridSize.y) + 
+			") does not fit the 8 bit tile rects of TWO_PHASE_INIT_SORT_LIST, using the atomic InitSortList instead."
+		);
+	}
+
+	// Initial estimate, adapted to the requested number of elements while rendering
+	this->sortCountReadbackWritten.fill(false);
+	this->numFramesBelowShrinkThreshold = 0;
+	this->maxRequestedSortElementsBelowThreshold = 0;
+	this->createSortBuffers(this->getNumSortElements(this->numGaussians));
+}
+
+void Renderer::createSortBuffers(uint32_t numSortElements)
+{
+	this->numSortElements = numSortElements;
+
+	// Gaussians list SBO for sorting (cleared every frame before use)
 	this->gaussiansSortListSBO = std::make_shared<StorageBuffer>();
 	this->gaussiansSortListSBO->createGpuBuffer(
 		this->gfxAllocContext,
-		sizeof(sortData[0]) * sortData.size(),
-		sortData.data()
+		GaussianSortList::getBufferSize(this->numSortElements),
+		nullptr
 	);
 
 	// Cull data
@@ -742,17 +1206,188 @@ void Renderer::initForScene(Scene& scene)
 		&cullData
 	);
 
-	// Range data
-	uint32_t numTiles = this->getNumTiles();
-	const std::vector<GaussianTileRangeData> dummyRangeData(numTiles);
-	this->gaussiansTileRangesSBO.createGpuBuffer(
+	// Find ranges indirect dispatch
+	FindRangesIndirectDispatch initFindRangesDispatch{};
+	initFindRangesDispatch.sizeX = (this->numSortElements + FIND_RANGES_GROUP_SIZE - 1) / FIND_RANGES_GROUP_SIZE;
+	initFindRangesDispatch.sizeY = 1;
+	initFindRangesDispatch.sizeZ = 1;
+	initFindRangesDispatch.numSortElements = this->numSortElements;
+	this->findRangesIndirectDispatchSBO.createGpuBuffer(
 		this->gfxAllocContext,
-		sizeof(dummyRangeData[0]) * dummyRangeData.size(),
-		dummyRangeData.data()
+		sizeof(FindRangesIndirectDispatch),
+		&initFindRangesDispatch,
+		VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
 	);
 
 	// Init gpu buffers specific to the gaussians within the current scene
-	this->gpuSort->initForScene(this->numSortElements, numTiles);
+	this->gpuSort->initForScene(this->numSortElements, this->getNumSortKeyBits());
+	if (this->gpuSort->writesTileRanges())
+	{
+		this->gpuSort->setTileRanges(
+			this->gaussiansTileRangesSBO, 
+			this->getNumTiles(), 
+			this->getNumCompactTileBits()
+		);
+	}
+
+#ifdef VALIDATE_GPU_SORT
+	this->sortValidator.create(
+		this->gfxAllocContext, 
+		this->numSortElements, 
+		this->getNumSortKeyBits(),
+		this->getNumTileBits(),
+		this->getNumCompactTileBits() == 0,
+		this->gpuSort->sortsLivePrefixOnly()
+	);
+#endif
+}
+
+void Renderer::cleanupSortBuffers()
+{
+#ifdef VALIDATE_GPU_SORT
+	this->sortValidator.cleanup();
+#endif
+	this->gpuSort->cleanupForScene();
+
+	if (this->gaussiansSortListSBO)
+		this->gaussiansSortListSBO->cleanup();
+	this->findRangesIndirectDispatchSBO.cleanup();
+	this->gaussiansCullDataSBO.cleanup();
+}
+
+void Renderer::updateNumResidentGaussians()
+{
+	// All gaussians of the current scene are already rendered
+	if (this->numGaussians >= this->numSceneGaussians)
+		return;
+
+	// Sort buffers grow through updateSortListCapacity() as more gaussians become visible
+	this->numGaussians = std::min(this->numUploadedGaussians.load(), this->numSceneGaussians);
+}
+
+void Renderer::recordSortCountReadback(CommandBuffer& commandBuffer)
+{
+	// Wait for all passes using the cull data
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_TRANSFER_READ_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		this->gaussiansCullDataSBO.getVkBuffer(),
+		this->gaussiansCullDataSBO.getBufferSize()
+	);
+
+	// Copy numGaussiansToRender, where x counts all requested elements, including dropped ones
+	commandBuffer.copyBuffer(
+		this->gaussiansCullDataSBO.getVkBuffer(),
+		this->sortCountReadback.getVkBuffer(GfxState::getFrameIndex()),
+		sizeof(GaussianCullData::numGaussiansToRender)
+	);
+
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_HOST_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_HOST_BIT,
+		this->sortCountReadback.getVkBuffer(GfxState::getFrameIndex()),
+		this->sortCountReadback.getBufferSize()
+	);
+
+	this->sortCountReadbackWritten[GfxState::getFrameIndex()] = true;
+}
+
+void Renderer::updateSortListCapacity()
+{
+	const uint32_t frameIndex = GfxState::getFrameIndex();
+	if (!this->sortCountReadbackWritten[frameIndex])
+		return;
+	this->sortCountReadbackWritten[frameIndex] = false;
+
+	const glm::uvec4 numGaussiansToRender = 
+		*static_cast<const glm::uvec4*>(this->sortCountReadback.getMappedData(frameIndex));
+	const uint32_t numRequested = numGaussiansToRender.x;
+
+#ifdef COMPARE_SPLAT_EXTENTS
+	if (this->numFramesUntilSplatExtentsLog > 0)
+	{
+		this->numFramesUntilSplatExtentsLog--;
+	}
+	else
+	{
+		this->numFramesUntilSplatExtentsLog = SPLAT_EXTENTS_LOG_INTERVAL;
+
+		const uint32_t numWithSquareExtents = numGaussiansToRender.z;
+		Log::write(
+			"Elements to sort: " + std::to_string(numRequested) + 
+			" (square 3 sigma extents: " + std::to_string(numWithSquareExtents) + ", " + 
+			std::to_string(numWithSquareExtents > 0 ? 100.0f * numRequested / numWithSquareExtents : 0.0f) + "%)"
+		);
+	}
+#endif
+
+	// InitSortList drops the elements beyond the capacity
+	const bool overflowed = numRequested > this->numSortElements;
+	if (overflowed)
+		this->numSortOverflowFrames++;
+
+	uint32_t newNumSortElements = this->numSortElements;
+	if (uint64_t(numRequested) * 100 > uint64_t(this->numSortElements) * SORT_LIST_GROW_PERCENT)
+	{
+		// Grow right away
+		newNumSortElements = this->getSortListCapacity(numRequested);
+	}
+	else if (uint64_t(numRequested) * 100 < uint64_t(this->numSortElements) * SORT_LIST_SHRINK_PERCENT)
+	{
+		// Shrink once the requests have stayed far below the capacity for a while
+		this->maxRequestedSortElementsBelowThreshold = 
+			std::max(this->maxRequestedSortElementsBelowThreshold, numRequested);
+		if (++this->numFramesBelowShrinkThreshold >= SORT_LIST_SHRINK_FRAMES)
+			newNumSortElements = this->getSortListCapacity(this->maxRequestedSortElementsBelowThreshold);
+	}
+	else
+	{
+		this->numFramesBelowShrinkThreshold = 0;
+		this->maxRequestedSortElementsBelowThreshold = 0;
+	}
+
+	if (newNumSortElements == this->numSortElements)
+		return;
+
+	if (overflowed)
+	{
+		Log::warning(
+			"Sort list overflowed, " + std::to_string(numRequested) + 
+			" elements were requested with a capacity of " + std::to_string(this->numSortElements) + "."
+		);
+	}
+	Log::write(
+		"Sort list capacity: " + std::to_string(this->numSortElements) + " -> " + std::to_string(newNumSortElements) + 
+		" elements (" + std::to_string(GaussianSortList::getBufferSize(newNumSortElements) / (1024 * 1024)) + " MB)"
+	);
+
+	// Frames in flight might still use the sort buffers
+	{
+		std::lock_guard<std::mutex> queueLock(this->queueFamilies.getQueueMutex());
+		this->device.waitIdle();
+	}
+	this->cleanupSortBuffers();
+	this->createSortBuffers(newNumSortElements);
+
+	this->numFramesBelowShrinkThreshold = 0;
+	this->maxRequestedSortElementsBelowThreshold = 0;
+}
+
+void Renderer::cleanupForScene()
+{
+	this->cleanupSortBuffers();
+
+	this->initSortListBlockSumsSBO.cleanup();
+	this->initSortListCountsSBO.cleanup();
+	this->initSortListTileRectsSBO.cleanup();
+	this->gaussiansTileRangesSBO.cleanup();
+	this->gaussiansSplatSBO.cleanup();
+	this->gaussiansShSBO.cleanup();
+	this->gaussiansGeometrySBO.cleanup();
 }
 
 void Renderer::setWindow(Window& window)
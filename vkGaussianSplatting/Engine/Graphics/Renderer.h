@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_glfw.h>
 #include <imgui/imgui_impl_vulkan.h>
@@ -18,7 +21,9 @@
 #include "Vulkan/QueryPoolArray.h"
 #include "Buffer/UniformBuffer.h"
 #include "Buffer/StorageBuffer.h"
+#include "Buffer/ReadbackBuffer.h"
 #include "Sort/GpuSort.h"
+#include "Sort/SortValidator.h"
 #include "Swapchain.h"
 #include "Camera.h"
 #include "GfxAllocContext.h"
@@ -32,10 +37,41 @@ class DescriptorPool;
 
 #define GPU_SORT_ALGORITHM (RADIX_SORT)
 
+// Picks the sort algorithm and work group size on first run for the device, 
+// instead of GPU_SORT_ALGORITHM. The choice is cached in GpuSortTuner::CACHE_PATH.
+//#define AUTOTUNE_GPU_SORT
+
+// Packs the tile index and a quantized depth into 32 bits of the sort keys, 
+// halving the number of bits to sort (depth precision is reduced to 32 - tile bits)
+//#define COMPACT_SORT_KEYS
+
 //#define RECORD_GPU_TIMES
 //#define RECORD_CPU_TIMES
 //#define ALERT_FINAL_AVERAGE
 
+// Averages GPU times for each gaussian ordering in turn, 
+// reordering the gaussians between measurements (requires RECORD_GPU_TIMES)
+//#define BENCHMARK_GAUSSIAN_ORDERING
+
+// Also counts the elements that the square extents of 3 standard deviations would 
+// have requested, before the opacity and the exact ellipse-tile overlap were taken 
+// into account, and logs both counts every SPLAT_EXTENTS_LOG_INTERVAL frames
+//#define COMPARE_SPLAT_EXTENTS
+
+// Splits InitSortList into a pass writing the tile rect and number of elements of each 
+// gaussian, a scan of those numbers, and a pass writing the elements at the scanned 
+// offsets. Avoids contention on the single atomic counter, and writes the elements in 
+// gaussian order, making the sort list of a frame deterministic.
+//#define TWO_PHASE_INIT_SORT_LIST
+
+// Averages GPU times for the atomic and the two-phase InitSortList in turn 
+// (requires RECORD_GPU_TIMES)
+//#define BENCHMARK_INIT_SORT_LIST
+
+// Periodically compares the GPU sort against a CPU reference. 
+// Without COMPACT_SORT_KEYS, it also measures how often compact keys would reorder splats.
+//#define VALIDATE_GPU_SORT
+
 class Renderer
 {
 private:
@@ -74,9 +110,39 @@ private:
 	THIS_IS_NOT_ALLOWED___MAKE_A_COMPILE_ERROR
 #endif
 
+#if defined(BENCHMARK_GAUSSIAN_ORDERING) && !defined(RECORD_GPU_TIMES)
+	BENCHMARK_GAUSSIAN_ORDERING_REQUIRES_RECORD_GPU_TIMES
+#endif
+
+#if defined(BENCHMARK_INIT_SORT_LIST) && !defined(RECORD_GPU_TIMES)
+	BENCHMARK_INIT_SORT_LIST_REQUIRES_RECORD_GPU_TIMES
+#endif
+
+#if defined(BENCHMARK_INIT_SORT_LIST) && defined(BENCHMARK_GAUSSIAN_ORDERING)
+	BENCHMARK_INIT_SORT_LIST_AND_BENCHMARK_GAUSSIAN_ORDERING_ARE_NOT_ALLOWED_TOGETHER
+#endif
+
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+	uint32_t benchmarkOrderingIndex;
+	std::string benchmarkOrderingResults;
+#endif
+
+#ifdef BENCHMARK_INIT_SORT_LIST
+	uint32_t benchmarkInitSortListIndex;
+	std::string benchmarkInitSortListResults;
+#endif
+
 	// Pipelines/layouts
 	PipelineLayout initSortListPipelineLayout;
-	Pipeline initSortListPipeline;
+	std::array<Pipeline, GaussianShData::MAX_DEGREE + 1> initSortListPipelines; // One per spherical harmonics degree
+	PipelineLayout initSortListReducePipelineLayout;
+	Pipeline initSortListReducePipeline;
+	PipelineLayout initSortListScanPipelineLayout;
+	Pipeline initSortListScanPipeline;
+	PipelineLayout initSortListWritePipelineLayout;
+	Pipeline initSortListWritePipeline;
+	PipelineLayout findRangesIndirectSetupPipelineLayout;
+	Pipeline findRangesIndirectSetupPipeline;
 	PipelineLayout findRangesPipelineLayout;
 	Pipeline findRangesPipeline;
 	PipelineLayout renderGaussiansPipelineLayout;
@@ -97,14 +163,46 @@ private:
 	FenceArray inFlightFences;
 
 	UniformBuffer camUBO;
-	StorageBuffer gaussiansSBO;
+	StorageBuffer gaussiansGeometrySBO;
+	StorageBuffer gaussiansShSBO;
+	StorageBuffer gaussiansSplatSBO;
 	StorageBuffer gaussiansCullDataSBO;
+	StorageBuffer findRangesIndirectDispatchSBO;
 	StorageBuffer gaussiansTileRangesSBO;
+	StorageBuffer initSortListTileRectsSBO;
+	StorageBuffer initSortListCountsSBO;
+	StorageBuffer initSortListBlockSumsSBO;
 	std::shared_ptr<StorageBuffer> gaussiansSortListSBO;
 
+	// Number of sort elements requested by InitSortList, read back a few frames 
+	// later to adapt the sort list capacity
+	ReadbackBuffer sortCountReadback;
+#ifdef VALIDATE_GPU_SORT
+	SortValidator sortValidator;
+#endif
+	std::array<bool, GfxSettings::FRAMES_IN_FLIGHT> sortCountReadbackWritten;
+	uint32_t numFramesBelowShrinkThreshold;
+	uint32_t maxRequestedSortElementsBelowThreshold;
+	uint32_t numSortOverflowFrames;
+#ifdef COMPARE_SPLAT_EXTENTS
+	uint32_t numFramesUntilSplatExtentsLog;
+#endif
+
 	std::shared_ptr<GpuSort> gpuSort;
 
-	uint32_t numGaussians;
+	// Set by TWO_PHASE_INIT_SORT_LIST, but only used if the tile rects fit into 8 bits per side
+	bool twoPhaseInitSortList;
+
+	// Gaussians of the next scene, uploaded while the current scene is rendered
+	StorageBuffer loadedGaussiansGeometrySBO;
+	StorageBuffer loadedGaussiansShSBO;
+	uint32_t numLoadedGaussians;
+	uint32_t loadedShDegree;
+	std::atomic<uint32_t> numUploadedGaussians;
+
+	uint32_t numSceneGaussians;
+	uint32_t sceneShDegree;
+	uint32_t numGaussians; // Resident, and therefore rendered, gaussians out of numSceneGaussians
 	uint32_t numSortElements;
 
 	Window* window;
@@ -125,15 +223,40 @@ private:
 
 	void resizeWindow();
 	void cleanupImgui();
+	void cleanupForScene();
+
+	void createSortBuffers(uint32_t numSortElements);
+	void cleanupSortBuffers();
+	void updateNumResidentGaussians();
+	void recordSortCountReadback(CommandBuffer& commandBuffer);
+	void updateSortListCapacity();
 
 	void renderImgui(CommandBuffer& commandBuffer, ImDrawData* imguiDrawData, uint32_t imageIndex);
 	void computeInitSortList(CommandBuffer& commandBuffer, const Camera& camera);
+	void computeInitSortListElements(CommandBuffer& commandBuffer, const VkDescriptorBufferInfo& tileRectsInfo);
 	void computeRanges(CommandBuffer& commandBuffer);
 	void computeRenderGaussians(CommandBuffer& commandBuffer, uint32_t imageIndex);
 
+#ifdef BENCHMARK_GAUSSIAN_ORDERING
+	void benchmarkNextGaussianOrdering();
+#endif
+
+#ifdef BENCHMARK_INIT_SORT_LIST
+	void benchmarkNextInitSortList();
+#endif
+
 	inline float getNewAvgTime(float avgValue, float newValue, float t) const { return (1.0f - t)* avgValue + t * newValue; }
 
+	glm::uvec2 getTileGridSize() const;
 	uint32_t getNumTiles() const;
+	uint32_t getNumTileBits() const;
+	uint32_t getNumCompactTileBits() const;
+	uint32_t getNumSortKeyBits() const;
+	uint32_t getNumInitListScanBlocks(uint32_t numGaussians) const;
+	bool usesTwoPhaseInitSortList() const;
+	uint32_t getMinNumBits(uint32_t x) const;
+	uint32_t getNumSortElements(uint32_t numResidentGaussians) const;
+	uint32_t getSortListCapacity(uint32_t numRequestedSortElements) const;
 	uint32_t getCeilPowTwo(uint32_t x) const;
 
 	inline const VkDevice& getVkDevice() const { return this->device.getVkDevice(); }
@@ -143,15 +266,31 @@ public:
 	const static uint32_t WAIT_ELAPSED_FRAMES_FOR_AVG = 1000;
 
 	const static uint32_t INIT_LIST_WORK_GROUP_SIZE = 32;
+	const static uint32_t INIT_LIST_SCAN_WORK_GROUP_SIZE = 256;
+	const static uint32_t INIT_LIST_SCAN_ITEMS_PER_THREAD = 4;
+	const static uint32_t INIT_LIST_SCAN_BLOCK_SIZE = INIT_LIST_SCAN_WORK_GROUP_SIZE * INIT_LIST_SCAN_ITEMS_PER_THREAD;
+	const static uint32_t INIT_LIST_BLOCK_SCAN_WORK_GROUP_SIZE = 1024;
 	const static uint32_t TILE_SIZE = 16;
 	const static uint32_t FIND_RANGES_GROUP_SIZE = 16;
 
+	// Sort list capacity grows when the requested number of elements exceeds 
+	// SORT_LIST_GROW_PERCENT of it, and shrinks when the requests stay below 
+	// SORT_LIST_SHRINK_PERCENT for SORT_LIST_SHRINK_FRAMES frames. The new capacity 
+	// fits SORT_LIST_MARGIN_PERCENT of the requests, rounded up to a power of two.
+	const static uint32_t SORT_LIST_GROW_PERCENT = 90;
+	const static uint32_t SORT_LIST_SHRINK_PERCENT = 25;
+	const static uint32_t SORT_LIST_MARGIN_PERCENT = 125;
+	const static uint32_t SORT_LIST_SHRINK_FRAMES = 120;
+	const static uint32_t MIN_SORT_ELEMENTS = 1u << 16;
+	const static uint32_t SPLAT_EXTENTS_LOG_INTERVAL = 120;
+
 	bool framebufferResized = false;
 
 	Renderer();
 	~Renderer();
 
 	void init(ResourceManager& resourceManager);
+	void loadGaussiansForScene(const std::function<void(float)>& progressCallback);
 	void initForScene(Scene& scene);
 	void setWindow(Window& window);
 
@@ -162,6 +301,8 @@ public:
 
 	void generateMemoryDump();
 
+	inline bool isSceneFullyResident() const { return this->numGaussians >= this->numSceneGaussians; }
+
 	inline float getSwapchainAspectRatio() 
 		{ return (float) this->swapchain.getWidth() / this->swapchain.getHeight(); }
 	inline const GfxAllocContext& getGfxAllocContext() const { return this->gfxAllocContext; }
@@ -0,0 +1,310 @@
+#include "pch.h"
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include "ShCompression.h"
+
+void ShCompressionError::add(const ShCompressionError& other)
+{
+	this->maxColorDelta = std::max(this->maxColorDelta, other.maxColorDelta);
+	this->sumColorDelta += other.sumColorDelta;
+	this->numSamples += other.numSamples;
+}
+
+void ShCompression::encodeQuantizedChunk(
+	const ShStreamLayout& layout,
+	const GaussianShData* input,
+	size_t numGaussians,
+	uint32_t* output)
+{
+	assert(numGaussians <= QUANTIZATION_CHUNK_SIZE);
+
+	// Range of each higher band float within the chunk
+	float minValues[GaussianShData::NUM_COEFFS * 3];
+	float maxValues[GaussianShData::NUM_COEFFS * 3];
+	for (uint32_t j = 0; j < layout.numRestFloats; ++j)
+	{
+		minValues[j] = std::numeric_limits<float>::max();
+		maxValues[j] = std::numeric_limits<float>::lowest();
+	}
+	for (size_t i = 0; i < numGaussians; ++i)
+	{
+		for (uint32_t j = 0; j < layout.numRestFloats; ++j)
+		{
+			minValues[j] = std::min(minValues[j], input[i].coeffs[3 + j]);
+			maxValues[j] = std::max(maxValues[j], input[i].coeffs[3 + j]);
+		}
+	}
+
+	// Header, value = offset + scale * byte
+	float invScales[GaussianShData::NUM_COEFFS * 3];
+	for (uint32_t j = 0; j < layout.numRestFloats; ++j)
+	{
+		const float scale = (maxValues[j] - minValues[j]) / 255.0f;
+		invScales[j] = scale > 0.0f ? 1.0f / scale : 0.0f;
+
+		std::memcpy(&output[j * 2 + 0], &scale, sizeof(float));
+		std::memcpy(&output[j * 2 + 1], &minValues[j], sizeof(float));
+	}
+
+	// Gaussians
+	for (size_t i = 0; i < numGaussians; ++i)
+	{
+		uint32_t* gaussianWords = output + layout.chunkHeaderWords + i * layout.gaussianWords;
+		const float* coeffs = input[i].coeffs;
+
+		gaussianWords[0] = glm::packHalf2x16(glm::vec2(coeffs[0], coeffs[1]));
+		gaussianWords[1] = glm::packHalf2x16(glm::vec2(coeffs[2], 0.0f));
+
+		uint8_t quantized[GaussianShData::NUM_COEFFS * 3]{};
+		for (uint32_t j = 0; j < layout.numRestFloats; ++j)
+		{
+			const float normalized = (coeffs[3 + j] - minValues[j]) * invScales[j];
+			quantized[j] = (uint8_t) std::clamp(normalized + 0.5f, 0.0f, 255.0f);
+		}
+		std::memcpy(gaussianWords + 2, quantized, (layout.gaussianWords - 2) * sizeof(uint32_t));
+	}
+}
+
+void ShCompression::decodeGaussian(
+	ShStorageMode mode,
+	const ShStreamLayout& layout,
+	const uint32_t* stream,
+	size_t gaussianIndex,
+	GaussianShData& output)
+{
+	// Coefficients above the degree of the stream are not stored
+	std::memset(output.coeffs, 0, sizeof(output.coeffs));
+
+	switch (mode)
+	{
+	case ShStorageMode::FLOAT32:
+		std::memcpy(output.coeffs, stream + gaussianIndex * layout.gaussianWords, layout.numCoeffs * 3 * sizeof(float));
+		break;
+
+	case ShStorageMode::FLOAT16:
+	{
+		const uint32_t* gaussianWords = stream + gaussianIndex * layout.gaussianWords;
+		for (uint32_t f = 0; f < layout.numCoeffs * 3; ++f)
+			output.coeffs[f] = glm::unpackHalf2x16(gaussianWords[f / 2])[f % 2];
+		break;
+	}
+
+	case ShStorageMode::QUANTIZED_8:
+	{
+		const uint32_t* chunkWords = stream + (gaussianIndex / QUANTIZATION_CHUNK_SIZE) * layout.getChunkWords(QUANTIZATION_CHUNK_SIZE);
+		const uint32_t* gaussianWords =
+			chunkWords + layout.chunkHeaderWords + (gaussianIndex % QUANTIZATION_CHUNK_SIZE) * layout.gaussianWords;
+
+		const glm::vec2 dcRG = glm::unpackHalf2x16(gaussianWords[0]);
+		const glm::vec2 dcB = glm::unpackHalf2x16(gaussianWords[1]);
+		output.coeffs[0] = dcRG.x;
+		output.coeffs[1] = dcRG.y;
+		output.coeffs[2] = dcB.x;
+
+		const uint8_t* quantized = (const uint8_t*) (gaussianWords + 2);
+		for (uint32_t j = 0; j < layout.numRestFloats; ++j)
+		{
+			float scale, offset;
+			std::memcpy(&scale, &chunkWords[j * 2 + 0], sizeof(float));
+			std::memcpy(&offset, &chunkWords[j * 2 + 1], sizeof(float));
+			output.coeffs[3 + j] = offset + scale * float(quantized[j]);
+		}
+		break;
+	}
+	}
+}
+
+glm::vec3 ShCompression::getShColor(const glm::vec3& evalDir, const GaussianShData& sh, uint32_t numCoeffs)
+{
+	// Same as getShEval() and getShColor() in Common.glsl, with all bands of the degree
+	float pSH[GaussianShData::NUM_COEFFS];
+	const float fX = -evalDir.x;
+	const float fY = -evalDir.y;
+	const float fZ = evalDir.z;
+	const float fZ2 = fZ * fZ;
+
+	pSH[0] = 0.2820947917738781f;
+	if (numCoeffs >= 4)
+	{
+		const float fTmpA = -0.48860251190292f;
+		pSH[1] = fTmpA * fY;
+		pSH[2] = 0.4886025119029199f * fZ;
+		pSH[3] = fTmpA * fX;
+	}
+	if (numCoeffs >= 9)
+	{
+		const float fC1 = fX * fX - fY * fY;
+		const float fS1 = 2.0f * fX * fY;
+		const float fTmpA = 0.5462742152960395f;
+		const float fTmpB = -1.092548430592079f * fZ;
+		pSH[4] = fTmpA * fS1;
+		pSH[5] = fTmpB * fY;
+		pSH[6] = 0.9461746957575601f * fZ2 + -0.31539156525252f;
+		pSH[7] = fTmpB * fX;
+		pSH[8] = fTmpA * fC1;
+
+		if (numCoeffs >= 16)
+		{
+			const float fC0 = fX * fC1 - fY * fS1;
+			const float fS0 = fX * fS1 + fY * fC1;
+			const float fTmpB3 = 1.445305721320277f * fZ;
+			const float fTmpC = -2.285228997322329f * fZ2 + 0.4570457994644658f;
+			const float fTmpD = -0.5900435899266435f;
+			pSH[9] = fTmpD * fS0;
+			pSH[10] = fTmpB3 * fS1;
+			pSH[11] = fTmpC * fY;
+			pSH[12] = fZ * (1.865881662950577f * fZ2 + -1.119528997770346f);
+			pSH[13] = fTmpC * fX;
+			pSH[14] = fTmpB3 * fC1;
+			pSH[15] = fTmpD * fC0;
+		}
+	}
+
+	glm::vec3 result(0.5f);
+	for (uint32_t i = 0; i < numCoeffs; ++i)
+		result += glm::vec3(sh.coeffs[i * 3 + 0], sh.coeffs[i * 3 + 1], sh.coeffs[i * 3 + 2]) * pSH[i];
+
+	return glm::max(result, glm::vec3(0.0f));
+}
+
+ShStreamLayout ShCompression::getStreamLayout(ShStorageMode mode, uint32_t shDegree)
+{
+	assert(shDegree <= GaussianShData::MAX_DEGREE);
+
+	ShStreamLayout layout{};
+	layout.numCoeffs = GaussianShData::getNumCoeffs(shDegree);
+	layout.numRestFloats = (layout.numCoeffs - 1) * 3;
+
+	switch (mode)
+	{
+	case ShStorageMode::FLOAT32:
+		layout.gaussianWords = layout.numCoeffs * 3;
+		break;
+
+	case ShStorageMode::FLOAT16:
+		layout.gaussianWords = (layout.numCoeffs * 3 + 1) / 2;
+		break;
+
+	case ShStorageMode::QUANTIZED_8:
+		layout.chunkHeaderWords = layout.numRestFloats * 2;
+		layout.gaussianWords = 2 + (layout.numRestFloats + 3) / 4;
+		break;
+	}
+
+	return layout;
+}
+
+size_t ShCompression::getStreamSize(ShStorageMode mode, uint32_t shDegree, size_t numGaussians)
+{
+	const ShStreamLayout layout = ShCompression::getStreamLayout(mode, shDegree);
+	const size_t numFullChunks = numGaussians / QUANTIZATION_CHUNK_SIZE;
+	const size_t numRemainingGaussians = numGaussians % QUANTIZATION_CHUNK_SIZE;
+
+	size_t numWords = numFullChunks * layout.getChunkWords(QUANTIZATION_CHUNK_SIZE);
+	if (numRemainingGaussians > 0)
+		numWords += layout.getChunkWords((uint32_t) numRemainingGaussians);
+
+	return numWords * sizeof(uint32_t);
+}
+
+void ShCompression::encode(
+	ShStorageMode mode,
+	uint32_t shDegree,
+	const GaussianShData* input,
+	size_t numGaussians,
+	uint8_t* output)
+{
+	const ShStreamLayout layout = ShCompression::getStreamLayout(mode, shDegree);
+	uint32_t* outputWords = (uint32_t*) output;
+
+	switch (mode)
+	{
+	case ShStorageMode::FLOAT32:
+		for (size_t i = 0; i < numGaussians; ++i)
+			std::memcpy(outputWords + i * layout.gaussianWords, input[i].coeffs, layout.gaussianWords * sizeof(uint32_t));
+		break;
+
+	case ShStorageMode::FLOAT16:
+		for (size_t i = 0; i < numGaussians; ++i)
+		{
+			// Odd number of floats leaves the last half float as 0
+			const uint32_t numFloats = layout.numCoeffs * 3;
+			for (uint32_t k = 0; k < layout.gaussianWords; ++k)
+			{
+				outputWords[i * layout.gaussianWords + k] = glm::packHalf2x16(
+					glm::vec2(
+						input[i].coeffs[k * 2 + 0], 
+						k * 2 + 1 < numFloats ? input[i].coeffs[k * 2 + 1] : 0.0f
+					)
+				);
+			}
+		}
+		break;
+
+	case ShStorageMode::QUANTIZED_8:
+		for (size_t firstIndex = 0; firstIndex < numGaussians; firstIndex += QUANTIZATION_CHUNK_SIZE)
+		{
+			ShCompression::encodeQuantizedChunk(
+				layout,
+				input + firstIndex,
+				std::min((size_t) QUANTIZATION_CHUNK_SIZE, numGaussians - firstIndex),
+				outputWords + (firstIndex / QUANTIZATION_CHUNK_SIZE) * layout.getChunkWords(QUANTIZATION_CHUNK_SIZE)
+			);
+		}
+		break;
+	}
+}
+
+void ShCompression::measureError(
+	ShStorageMode mode,
+	uint32_t shDegree,
+	const GaussianShData* input,
+	size_t numGaussians,
+	const uint8_t* encoded,
+	ShCompressionError& error)
+{
+	// Directions along the axes and the diagonals
+	static const float INV_SQRT_3 = 0.5773502691896258f;
+	static const glm::vec3 EVAL_DIRS[] =
+	{
+		glm::vec3( 1.0f,  0.0f,  0.0f), glm::vec3(-1.0f,  0.0f,  0.0f),
+		glm::vec3( 0.0f,  1.0f,  0.0f), glm::vec3( 0.0f, -1.0f,  0.0f),
+		glm::vec3( 0.0f,  0.0f,  1.0f), glm::vec3( 0.0f,  0.0f, -1.0f),
+		glm::vec3( 1.0f,  1.0f,  1.0f) * INV_SQRT_3, glm::vec3(-1.0f,  1.0f,  1.0f) * INV_SQRT_3,
+		glm::vec3( 1.0f, -1.0f,  1.0f) * INV_SQRT_3, glm::vec3(-1.0f, -1.0f,  1.0f) * INV_SQRT_3,
+		glm::vec3( 1.0f,  1.0f, -1.0f) * INV_SQRT_3, glm::vec3(-1.0f,  1.0f, -1.0f) * INV_SQRT_3,
+		glm::vec3( 1.0f, -1.0f, -1.0f) * INV_SQRT_3, glm::vec3(-1.0f, -1.0f, -1.0f) * INV_SQRT_3
+	};
+
+	const ShStreamLayout layout = ShCompression::getStreamLayout(mode, shDegree);
+	GaussianShData decoded{};
+	for (size_t i = 0; i < numGaussians; ++i)
+	{
+		ShCompression::decodeGaussian(mode, layout, (const uint32_t*) encoded, i, decoded);
+
+		for (const glm::vec3& evalDir : EVAL_DIRS)
+		{
+			const glm::vec3 colorDelta = glm::abs(
+				ShCompression::getShColor(evalDir, input[i], layout.numCoeffs) -
+				ShCompression::getShColor(evalDir, decoded, layout.numCoeffs)
+			);
+			const float maxChannelDelta = std::max(std::max(colorDelta.x, colorDelta.y), colorDelta.z);
+
+			error.maxColorDelta = std::max(error.maxColorDelta, maxChannelDelta);
+			error.sumColorDelta += maxChannelDelta;
+			error.numSamples++;
+		}
+	}
+}
+
+const char* ShCompression::getModeName(ShStorageMode mode)
+{
+	switch (mode)
+	{
+	case ShStorageMode::FLOAT32: return "FLOAT32";
+	case ShStorageMode::FLOAT16: return "FLOAT16";
+	case ShStorageMode::QUANTIZED_8: return "QUANTIZED_8";
+	}
+
+	return "UNKNOWN";
+}
\ No newline at end of file
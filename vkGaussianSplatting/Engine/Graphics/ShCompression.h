@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Storage of the spherical harmonics stream on the GPU.
+// Has to match SH_STORAGE_* in GaussiansStructs.glsl.
+enum class ShStorageMode : uint32_t
+{
+	FLOAT32 = 0,		// 192 bytes per gaussian at degree 3
+	FLOAT16 = 1,		// 96 bytes per gaussian at degree 3
+	QUANTIZED_8 = 2		// 56 bytes per gaussian at degree 3. Half precision DC term and 8 bit higher bands,
+						// with a scale and offset per coefficient for each chunk of gaussians.
+};
+
+// Color difference between original and compressed spherical harmonics
+struct ShCompressionError
+{
+	float maxColorDelta = 0.0f;
+	double sumColorDelta = 0.0;
+	uint64_t numSamples = 0;
+
+	void add(const ShCompressionError& other);
+
+	inline float getMeanColorDelta() const { return this->numSamples > 0 ? float(this->sumColorDelta / double(this->numSamples)) : 0.0f; }
+};
+
+// Layout of the spherical harmonics stream for one storage mode and degree, in 32 bit words
+struct ShStreamLayout
+{
+	uint32_t numCoeffs;
+	uint32_t numRestFloats; // Floats of the bands above the DC term
+	uint32_t chunkHeaderWords; // Per quantization chunk
+	uint32_t gaussianWords; // Per gaussian
+
+	inline uint32_t getChunkWords(uint32_t chunkSize) const { return this->chunkHeaderWords + chunkSize * this->gaussianWords; }
+};
+
+// Encodes the packed spherical harmonics of gaussians into the layout read by 
+// InitSortList. Only the N = (degree + 1)^2 coefficients of the scene are stored.
+// The stream is an array of 32 bit words:
+// - FLOAT32: N * 3 floats per gaussian
+// - FLOAT16: N * 3 half floats per gaussian, two per word
+// - QUANTIZED_8: chunks of QUANTIZATION_CHUNK_SIZE gaussians, each starting with
+//   (scale, offset) for the higher band floats, followed by each gaussian:
+//   DC as half floats in 2 words, then the higher bands as bytes.
+class ShCompression
+{
+public:
+	// Has to match SH_QUANTIZATION_CHUNK_SIZE in GaussiansStructs.glsl
+	static const uint32_t QUANTIZATION_CHUNK_SIZE = 256;
+
+private:
+	static void encodeQuantizedChunk(
+		const ShStreamLayout& layout,
+		const GaussianShData* input,
+		size_t numGaussians,
+		uint32_t* output);
+
+	static void decodeGaussian(
+		ShStorageMode mode,
+		const ShStreamLayout& layout,
+		const uint32_t* stream,
+		size_t gaussianIndex,
+		GaussianShData& output);
+
+	static glm::vec3 getShColor(const glm::vec3& evalDir, const GaussianShData& sh, uint32_t numCoeffs);
+
+public:
+	static ShStreamLayout getStreamLayout(ShStorageMode mode, uint32_t shDegree);
+
+	// Size in bytes of the stream holding the first numGaussians gaussians.
+	// Also the byte offset of gaussian numGaussians, if it starts a chunk.
+	static size_t getStreamSize(ShStorageMode mode, uint32_t shDegree, size_t numGaussians);
+
+	// The first gaussian has to start a quantization chunk,
+	// and the stream is written from the start of that chunk
+	static void encode(
+		ShStorageMode mode,
+		uint32_t shDegree,
+		const GaussianShData* input,
+		size_t numGaussians,
+		uint8_t* output);
+
+	// Accumulates the difference in color between the original and
+	// encoded gaussians, evaluated for a set of view directions
+	static void measureError(
+		ShStorageMode mode,
+		uint32_t shDegree,
+		const GaussianShData* input,
+		size_t numGaussians,
+		const uint8_t* encoded,
+		ShCompressionError& error);
+
+	static const char* getModeName(ShStorageMode mode);
+};
\ No newline at end of file
@@ -6,9 +6,14 @@
 
 struct InitSortListPCD
 {
-	glm::vec4 clipPlanes; // vec4(nearPlane, farPlane, numGaussians, 0)
+	glm::vec4 clipPlanes; // vec4(nearPlane, farPlane, numGaussians, twoPhase)
 	glm::vec4 camPos; // vec4(x, y, z, shMode)
-	glm::uvec4 resolution; // uvec4(width, height, 0, 0)
+	glm::uvec4 resolution; // uvec4(width, height, numCompactTileBits, 0)
+};
+
+struct InitSortListScanPCD // Two-phase init sort list
+{
+	glm::uvec4 data; // uvec4(numGaussians, numBlocks, tileGridWidth, numCompactTileBits)
 };
 
 struct SortGaussiansBmsPCD // Bitonic merge sort
@@ -18,12 +23,27 @@ struct SortGaussiansBmsPCD // Bitonic merge sort
 
 struct SortGaussiansRsPCD // Radix sort
 {
-	glm::uvec4 data; // uvec4(shiftBits, 0, 0, 0)
+	glm::uvec4 data; // uvec4(shiftBits, numCompactTileBits, countTiles, 0)
+};
+
+struct TileRangeScanPCD
+{
+	glm::uvec4 data; // uvec4(numCompactTileBits, numTiles, 0, 0)
 };
 
 struct FindRangesPCD
 {
-	glm::uvec4 data; // uvec4(numSortElements, 0, 0, 0)
+	glm::uvec4 data; // uvec4(numCompactTileBits, 0, 0, 0)
+};
+
+// Has to reflect FindRangesIndirectSetupData in GaussiansStructs.glsl
+struct FindRangesIndirectDispatch
+{
+	uint32_t sizeX;
+	uint32_t sizeY;
+	uint32_t sizeZ;
+
+	uint32_t numSortElements;
 };
 
 struct RenderGaussiansPCD
@@ -56,29 +76,70 @@ struct RadixIndirectDispatch // Radix sort
 	uint32_t padding;
 };
 
+// Imported gaussian on the CPU, split into the GPU streams below when uploaded
 struct GaussianData
 {
-	// These remain unmodified
 	glm::vec4 position; // vec4(x, y, z, 0.0f)
 	glm::vec4 scale; // vec4(x, y, z, 0.0f)
 	glm::vec4 rot = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	glm::vec4 shCoeffs[16]{ glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) };	// i == 0 ? vec4(r_00, g_00, b_00, alpha) : vec4(r_lm, g_lm, b_lm, 0.0f)
+};
+
+// Read by every pass, for every gaussian
+struct GaussianGeometryData
+{
+	glm::vec4 position; // vec4(x, y, z, alpha)
+	glm::vec4 scale; // vec4(x, y, z, 0.0f)
+	glm::vec4 rot;
+};
+
+// Only read for gaussians passing the culling. 
+// On the GPU, only the coefficients up to the degree of the scene are stored.
+struct GaussianShData
+{
+	static const uint32_t MAX_DEGREE = 3;
+	static const uint32_t NUM_COEFFS = (MAX_DEGREE + 1) * (MAX_DEGREE + 1);
+
+	static inline uint32_t getNumCoeffs(uint32_t degree) { return (degree + 1) * (degree + 1); }
+
+	float coeffs[NUM_COEFFS * 3]; // (r_00, g_00, b_00, r_1-1, g_1-1, b_1-1, ...)
+};
+
+// Projected gaussian, written by InitSortList every frame and read by RenderGaussians
+struct GaussianSplatData
+{
+	glm::vec4 conicOpacity; // vec4(inverse 2D covariance xx, xy, yy, alpha)
+	glm::vec2 screenPos;
+	glm::uvec2 color; // RGB as half floats
+};
+
+// The sort list of N elements is stored in one buffer as N 64 bit keys, 
+// (tileIndex << 32) | depthKey, followed by N 32 bit values (gaussian indices).
+// Passes bind the keys and values separately, and only read what they need.
+struct GaussianSortList
+{
+	static const uint32_t KEY_SIZE = sizeof(uint64_t);
+	static const uint32_t VALUE_SIZE = sizeof(uint32_t);
 
-	// These are modified between GPU passes
-	glm::vec4 color; // vec4(r, g, b, alpha)
-	glm::vec4 covariance; // vec4(cov.x, cov.y, cov.z, 0.0f)
+	static inline uint64_t getKeysSize(uint32_t numSortElements) { return uint64_t(numSortElements) * KEY_SIZE; }
+	static inline uint64_t getValuesOffset(uint32_t numSortElements) { return getKeysSize(numSortElements); }
+	static inline uint64_t getValuesSize(uint32_t numSortElements) { return uint64_t(numSortElements) * VALUE_SIZE; }
+	static inline uint64_t getBufferSize(uint32_t numSortElements) { return uint64_t(numSortElements) * (KEY_SIZE + VALUE_SIZE); }
 };
 
-struct GaussianSortData
+// Tile rect and depth key of a gaussian, written by the first pass of the 
+// two-phase InitSortList
+struct GaussianTileRectData
 {
-	glm::uvec4 data; // uvec4(sortKey0, sortKey1, gaussianIndex, 0)
+	uint32_t tileRect; // (minX, minY, maxX, maxY) in 8 bits each, including min, excluding max
+	uint32_t depthKey;
 };
 
 struct GaussianCullData
 {
 	// X value is decided by the GPU
 	// Y remains constant
-	glm::uvec4 numGaussiansToRender; // uvec4(num, maxNumSortElements, 0, 0);
+	glm::uvec4 numGaussiansToRender; // uvec4(num, maxNumSortElements, numWithSquareExtents, 0);
 };
 
 struct GaussianTileRangeData
@@ -29,12 +29,12 @@ void Shader::createSpecializationInfo(const std::vector<SpecializationConstant>&
 	// Specialization constants
 	if (specializationConstants.size() > 0)
 	{
-		// Entries
+		// Entries (the value of each constant is stored directly in its data member)
 		this->specMapEntries.resize(specializationConstants.size());
 		for (size_t i = 0; i < this->specMapEntries.size(); ++i)
 		{
 			this->specMapEntries[i].constantID = i;
-			this->specMapEntries[i].offset = 0;
+			this->specMapEntries[i].offset = (uint32_t) (i * sizeof(SpecializationConstant) + offsetof(SpecializationConstant, data));
 			this->specMapEntries[i].size = specializationConstants[i].size;
 		}
 
@@ -43,7 +43,7 @@ void Shader::createSpecializationInfo(const std::vector<SpecializationConstant>&
 		{
 			(uint32_t)specializationConstants.size(),
 			this->specMapEntries.data(),
-			specializationConstants[0].size * specializationConstants.size(),
+			sizeof(SpecializationConstant) * specializationConstants.size(),
 			specializationConstants.data()
 		};
 	}
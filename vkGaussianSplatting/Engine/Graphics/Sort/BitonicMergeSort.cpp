@@ -2,6 +2,12 @@
 #include "BitonicMergeSort.h"
 #include "../Buffer/StorageBuffer.h"
 
+BitonicMergeSort::BitonicMergeSort(uint32_t workGroupSize)
+	: workGroupSize(workGroupSize),
+	maxNumSortElements(0)
+{
+}
+
 void BitonicMergeSort::dispatchBms(
 	CommandBuffer& commandBuffer,
 	BmsSubAlgorithm subAlgorithm,
@@ -21,7 +27,7 @@ void BitonicMergeSort::dispatchBms(
 	// Run compute shader
 	// Divide workload by 2, since 1 thread works on pairs of elements
 	commandBuffer.dispatch(
-		numElemToSort / BMS_WORK_GROUP_SIZE / 2
+		numElemToSort / this->workGroupSize / 2
 	);
 
 	commandBuffer.bufferMemoryBarrier(
@@ -39,6 +45,7 @@ void BitonicMergeSort::singleInitResources(const GfxAllocContext& allocContext)
 	this->sortGaussiansBmsPipelineLayout.createPipelineLayout(
 		*allocContext.device,
 		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
 		},
 		VK_SHADER_STAGE_COMPUTE_BIT,
@@ -49,12 +56,12 @@ void BitonicMergeSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->sortGaussiansBmsPipelineLayout,
 		"Resources/Shaders/BitonicMergeSort.comp.spv",
 		{
-			SpecializationConstant{ (void*) BMS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
 }
 
-void BitonicMergeSort::initForScene(uint32_t maxNumSortElements, uint32_t numTiles)
+void BitonicMergeSort::initForScene(uint32_t maxNumSortElements, uint32_t numSortKeyBits)
 {
 	this->maxNumSortElements = maxNumSortElements;
 }
@@ -68,7 +75,7 @@ void BitonicMergeSort::computeSort(
 	assert((uint32_t)(this->maxNumSortElements & (this->maxNumSortElements - 1)) == 0u);
 
 	// Make sure number of elements is large enough
-	assert(this->maxNumSortElements >= BMS_WORK_GROUP_SIZE * 2);
+	assert(this->maxNumSortElements >= this->workGroupSize * 2);
 
 	// Wait for work on initialization of the sorting list to finish
 	commandBuffer.bufferMemoryBarrier(
@@ -84,14 +91,18 @@ void BitonicMergeSort::computeSort(
 	commandBuffer.bindPipeline(this->sortGaussiansBmsPipeline);
 
 	// Binding 0
-	VkDescriptorBufferInfo inputOutputGaussiansSortInfo{};
-	inputOutputGaussiansSortInfo.buffer = gaussiansSortListSBO->getVkBuffer();
-	inputOutputGaussiansSortInfo.range = gaussiansSortListSBO->getBufferSize();
+	VkDescriptorBufferInfo inputOutputGaussiansSortKeysInfo = 
+		GpuSort::getSortKeysInfo(*gaussiansSortListSBO, this->maxNumSortElements);
+
+	// Binding 1
+	VkDescriptorBufferInfo inputOutputGaussiansSortValuesInfo = 
+		GpuSort::getSortValuesInfo(*gaussiansSortListSBO, this->maxNumSortElements);
 
 	// Descriptor set
-	std::array<VkWriteDescriptorSet, 1> computeWriteDescriptorSets
+	std::array<VkWriteDescriptorSet, 2> computeWriteDescriptorSets
 	{
-		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputOutputGaussiansSortInfo)
+		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputOutputGaussiansSortKeysInfo),
+		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputOutputGaussiansSortValuesInfo)
 	};
 	commandBuffer.pushDescriptorSet(
 		this->sortGaussiansBmsPipelineLayout,
@@ -100,7 +111,7 @@ void BitonicMergeSort::computeSort(
 		computeWriteDescriptorSets.data()
 	);
 
-	uint32_t h = BMS_WORK_GROUP_SIZE * 2;
+	uint32_t h = this->workGroupSize * 2;
 
 	this->dispatchBms(
 		commandBuffer,
@@ -109,6 +120,7 @@ void BitonicMergeSort::computeSort(
 		this->maxNumSortElements,
 		gaussiansSortListSBO
 	);
+	this->markPass(commandBuffer, "local sort");
 
 	h *= 2;
 
@@ -124,7 +136,7 @@ void BitonicMergeSort::computeSort(
 
 		for (uint32_t hh = h / 2; hh > 1; hh /= 2)
 		{
-			if (hh <= BMS_WORK_GROUP_SIZE * 2)
+			if (hh <= this->workGroupSize * 2)
 			{
 				this->dispatchBms(
 					commandBuffer,
@@ -146,9 +158,15 @@ void BitonicMergeSort::computeSort(
 				);
 			}
 		}
+		this->markPass(commandBuffer, "merge");
 	}
 }
 
+void BitonicMergeSort::cleanupForScene()
+{
+
+}
+
 void BitonicMergeSort::cleanup()
 {
 	this->sortGaussiansBmsPipeline.cleanup();
@@ -7,8 +7,6 @@ class StorageBuffer;
 class BitonicMergeSort : public GpuSort
 {
 private:
-	const static uint32_t BMS_WORK_GROUP_SIZE = 512;
-
 	enum class BmsSubAlgorithm
 	{
 		LOCAL_BMS = 0,
@@ -20,6 +18,7 @@ private:
 	PipelineLayout sortGaussiansBmsPipelineLayout;
 	Pipeline sortGaussiansBmsPipeline;
 
+	uint32_t workGroupSize;
 	uint32_t maxNumSortElements;
 
 	void dispatchBms(
@@ -30,12 +29,18 @@ private:
 		std::shared_ptr<StorageBuffer>& gaussiansSortListSBO);
 
 public:
+	const static uint32_t BMS_WORK_GROUP_SIZE = 512;
+
+	// Each work group sorts 2 * workGroupSize elements locally
+	BitonicMergeSort(uint32_t workGroupSize = BMS_WORK_GROUP_SIZE);
+
 	virtual void singleInitResources(const GfxAllocContext& allocContext) override;
-	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numTiles) override;
+	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numSortKeyBits) override;
 	virtual void computeSort(
 		CommandBuffer& commandBuffer,
 		StorageBuffer& gaussiansCullDataSBO,
 		std::shared_ptr<StorageBuffer>& gaussiansSortListSBO) override;
+	virtual void cleanupForScene() override;
 	virtual void cleanup() override;
 
 	virtual void gpuClearBuffers(CommandBuffer& commandBuffer) override;
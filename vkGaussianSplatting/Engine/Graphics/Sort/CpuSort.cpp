@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "CpuSort.h"
+
+template <typename KeyType>
+void CpuSort::sortNarrowed(
+	const uint64_t* unsortedKeys,
+	const uint32_t* unsortedValues,
+	uint32_t numSortElements,
+	uint32_t numSortKeyBits,
+	CpuSortResult& result)
+{
+	std::vector<KeyType> keys(numSortElements);
+	std::vector<uint32_t> values(unsortedValues, unsortedValues + numSortElements);
+	for (uint32_t i = 0; i < numSortElements; ++i)
+		keys[i] = KeyType(unsortedKeys[i]);
+
+	// Only the sort itself is timed, like the sort passes on the GPU
+	const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	ParallelRadixSort<KeyType>::sort(keys, values, numSortKeyBits);
+	const std::chrono::duration<float, std::milli> sortDuration = std::chrono::high_resolution_clock::now() - startTime;
+	result.sortMs = sortDuration.count();
+
+	result.keys.resize(numSortElements);
+	for (uint32_t i = 0; i < numSortElements; ++i)
+		result.keys[i] = uint64_t(keys[i]);
+	result.values.swap(values);
+}
+
+CpuSortResult CpuSort::sort(
+	const uint64_t* unsortedKeys,
+	const uint32_t* unsortedValues,
+	uint32_t numSortElements,
+	uint32_t numSortKeyBits)
+{
+	assert(numSortKeyBits <= 64);
+
+	CpuSortResult result{};
+	if (numSortKeyBits <= 32)
+		CpuSort::sortNarrowed<uint32_t>(unsortedKeys, unsortedValues, numSortElements, numSortKeyBits, result);
+	else
+		CpuSort::sortNarrowed<uint64_t>(unsortedKeys, unsortedValues, numSortElements, numSortKeyBits, result);
+
+	return result;
+}
\ No newline at end of file
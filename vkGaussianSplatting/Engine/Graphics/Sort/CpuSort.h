@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../../Dev/ParallelRadixSort.h"
+
+struct CpuSortResult
+{
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> values;
+	float sortMs = 0.0f;
+};
+
+// CPU counterpart of GpuSort, with the same key/value semantics: 
+// a stable sort of the used elements in a sort list, by the lowest numSortKeyBits bits of 
+// each key. Runs the multithreaded radix sort on keys narrowed to the smallest width holding 
+// those bits. Used as the reference when validating GPU sorts, and as a baseline to compare against.
+class CpuSort
+{
+private:
+	template <typename KeyType>
+	static void sortNarrowed(
+		const uint64_t* unsortedKeys,
+		const uint32_t* unsortedValues,
+		uint32_t numSortElements,
+		uint32_t numSortKeyBits,
+		CpuSortResult& result);
+
+public:
+	// Sorts a host copy of the first numSortElements elements in a sort list
+	static CpuSortResult sort(
+		const uint64_t* unsortedKeys,
+		const uint32_t* unsortedValues,
+		uint32_t numSortElements,
+		uint32_t numSortKeyBits);
+};
\ No newline at end of file
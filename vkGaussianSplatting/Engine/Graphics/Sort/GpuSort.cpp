@@ -1,2 +1,32 @@
 #include "pch.h"
 #include "GpuSort.h"
+#include "GpuSortPassTimer.h"
+#include "../Buffer/StorageBuffer.h"
+
+VkDescriptorBufferInfo GpuSort::getSortKeysInfo(const StorageBuffer& sortList, uint32_t numSortElements)
+{
+	VkDescriptorBufferInfo keysInfo{};
+	keysInfo.buffer = sortList.getVkBuffer();
+	keysInfo.offset = 0;
+	keysInfo.range = GaussianSortList::getKeysSize(numSortElements);
+
+	return keysInfo;
+}
+
+VkDescriptorBufferInfo GpuSort::getSortValuesInfo(const StorageBuffer& sortList, uint32_t numSortElements)
+{
+	// The number of sort elements is a power of two, which 
+	// keeps the offset aligned to minStorageBufferOffsetAlignment
+	VkDescriptorBufferInfo valuesInfo{};
+	valuesInfo.buffer = sortList.getVkBuffer();
+	valuesInfo.offset = GaussianSortList::getValuesOffset(numSortElements);
+	valuesInfo.range = GaussianSortList::getValuesSize(numSortElements);
+
+	return valuesInfo;
+}
+
+void GpuSort::markPass(CommandBuffer& commandBuffer, const std::string& passName)
+{
+	if (this->passTimer)
+		this->passTimer->markPass(commandBuffer, passName);
+}
\ No newline at end of file
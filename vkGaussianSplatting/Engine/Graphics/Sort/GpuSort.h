@@ -4,19 +4,46 @@
 #define RADIX_SORT 1
 
 class StorageBuffer;
+class GpuSortPassTimer;
 
 class GpuSort
 {
 private:
+	GpuSortPassTimer* passTimer = nullptr;
+
+protected:
+	// Marks the end of a pass, if the passes are being timed
+	void markPass(CommandBuffer& commandBuffer, const std::string& passName);
 
 public:
+	// Descriptor infos for the key and value arrays of a sort list
+	static VkDescriptorBufferInfo getSortKeysInfo(const StorageBuffer& sortList, uint32_t numSortElements);
+	static VkDescriptorBufferInfo getSortValuesInfo(const StorageBuffer& sortList, uint32_t numSortElements);
+
 	virtual void singleInitResources(const GfxAllocContext& allocContext) = 0;
-	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numTiles) = 0;
+	// Only the lowest numSortKeyBits bits of the keys are sorted
+	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numSortKeyBits) = 0;
 	virtual void computeSort(
 		CommandBuffer& commandBuffer,
 		StorageBuffer& gaussiansCullDataSBO,
 		std::shared_ptr<StorageBuffer>& gaussiansSortListSBO) = 0;
+	virtual void cleanupForScene() = 0;
 	virtual void cleanup() = 0;
 
 	virtual void gpuClearBuffers(CommandBuffer& commandBuffer) = 0;
+
+	// Sorts that know the tile ranges once sorted can write them directly, 
+	// so the renderer can skip FindRanges. Called after initForScene().
+	inline virtual bool writesTileRanges() const { return false; }
+	virtual void setTileRanges(
+		StorageBuffer& tileRangesSBO,
+		uint32_t numTiles,
+		uint32_t numCompactTileBits) { }
+
+	// Sorts that only read and write the first numGaussiansToRender.x elements, 
+	// through indirect dispatches. The rest of the sort list is then never cleared.
+	inline virtual bool sortsLivePrefixOnly() const { return false; }
+
+	// Times each pass recorded by computeSort() while set. nullptr stops timing.
+	inline void setPassTimer(GpuSortPassTimer* passTimer) { this->passTimer = passTimer; }
 };
\ No newline at end of file
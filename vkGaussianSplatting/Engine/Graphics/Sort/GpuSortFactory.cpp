@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "GpuSortFactory.h"
+#include "BitonicMergeSort.h"
+#include "RadixSort.h"
+#include "../GpuProperties.h"
+
+std::shared_ptr<GpuSort> GpuSortFactory::create(const GpuSortConfig& config)
+{
+	if (!GpuSortFactory::isSupported(config.sortAlgorithm))
+	{
+		Log::warning(GpuSortFactory::getName(config.sortAlgorithm) + " is not supported by this device, using radix sort instead.");
+		return std::make_shared<RadixSort>();
+	}
+
+	switch (config.sortAlgorithm)
+	{
+	case BITONIC_MERGE_SORT:
+		return config.workGroupSize > 0 ? 
+			std::make_shared<BitonicMergeSort>(config.workGroupSize) : 
+			std::make_shared<BitonicMergeSort>();
+
+	case RADIX_SORT:
+		return config.workGroupSize > 0 ? 
+			std::make_shared<RadixSort>(config.workGroupSize) : 
+			std::make_shared<RadixSort>();
+	}
+
+	Log::error("Unknown sort algorithm: " + std::to_string(config.sortAlgorithm));
+	return nullptr;
+}
+
+bool GpuSortFactory::isSupported(uint32_t sortAlgorithm)
+{
+	switch (sortAlgorithm)
+	{
+	case BITONIC_MERGE_SORT:
+	case RADIX_SORT:
+		return true;
+	}
+
+	return false;
+}
+
+std::vector<uint32_t> GpuSortFactory::getWorkGroupSizeCandidates(uint32_t sortAlgorithm)
+{
+	std::vector<uint32_t> candidates;
+	if (sortAlgorithm == BITONIC_MERGE_SORT)
+		candidates = { 128, 256, 512 };
+	else if (sortAlgorithm == RADIX_SORT)
+		candidates = { 64, 128, 256 };
+
+	// Remove sizes above the limits of the device. 
+	// The radix sort tile counts push its largest size past the 16 KiB guaranteed by Vulkan.
+	candidates.erase(
+		std::remove_if(
+			candidates.begin(), 
+			candidates.end(), 
+			[&](uint32_t size) 
+			{ 
+				return size > GpuProperties::getMaxComputeWorkGroupInvocations() ||
+					(sortAlgorithm == RADIX_SORT && RadixSort::getSharedMemorySize(size) > GpuProperties::getMaxComputeSharedMemorySize());
+			}
+		),
+		candidates.end()
+	);
+
+	return candidates;
+}
+
+std::string GpuSortFactory::getName(uint32_t sortAlgorithm)
+{
+	switch (sortAlgorithm)
+	{
+	case BITONIC_MERGE_SORT:	return "Bitonic merge sort";
+	case RADIX_SORT:			return "Radix sort";
+	}
+
+	return "Unknown sort";
+}
+
+std::string GpuSortFactory::toString(const GpuSortConfig& config)
+{
+	return GpuSortFactory::getName(config.sortAlgorithm) + 
+		(config.workGroupSize > 0 ? " (work group size " + std::to_string(config.workGroupSize) + ")" : "");
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "GpuSort.h"
+
+struct GpuSortConfig
+{
+	uint32_t sortAlgorithm = RADIX_SORT;
+	uint32_t workGroupSize = 0; // 0 for the default of the sort
+};
+
+// Creates any GpuSort at runtime, from the algorithm ids in GpuSort.h.
+class GpuSortFactory
+{
+public:
+	static std::shared_ptr<GpuSort> create(const GpuSortConfig& config);
+
+	// Sorts the device has the required features for
+	static bool isSupported(uint32_t sortAlgorithm);
+
+	// Work group sizes a sort can be tuned with. Empty if it is fixed.
+	static std::vector<uint32_t> getWorkGroupSizeCandidates(uint32_t sortAlgorithm);
+
+	static std::string getName(uint32_t sortAlgorithm);
+	static std::string toString(const GpuSortConfig& config);
+};
\ No newline at end of file
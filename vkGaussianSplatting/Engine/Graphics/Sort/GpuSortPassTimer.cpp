@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "GpuSortPassTimer.h"
+#include "../GpuProperties.h"
+
+void GpuSortPassTimer::create(Device& device)
+{
+	this->queryPool.create(device, 1, MAX_NUM_TIMESTAMPS);
+	this->passNames.reserve(MAX_NUM_TIMESTAMPS);
+}
+
+void GpuSortPassTimer::cleanup()
+{
+	this->queryPool.cleanup();
+	this->passNames.clear();
+}
+
+void GpuSortPassTimer::begin(CommandBuffer& commandBuffer)
+{
+	this->passNames.clear();
+
+	commandBuffer.resetEntireQueryPool(this->queryPool[0], this->queryPool.getQueryCount());
+	commandBuffer.writeTimestamp(this->queryPool[0], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+}
+
+void GpuSortPassTimer::markPass(CommandBuffer& commandBuffer, const std::string& passName)
+{
+	// Timestamp 0 is written by begin()
+	const uint32_t queryIndex = uint32_t(this->passNames.size()) + 1;
+	if (queryIndex >= this->queryPool.getQueryCount())
+	{
+		Log::warning("Too many sort passes to time. Skipping pass: " + passName);
+		return;
+	}
+
+	commandBuffer.writeTimestamp(this->queryPool[0], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queryIndex);
+	this->passNames.push_back(passName);
+}
+
+std::vector<GpuSortPassTime> GpuSortPassTimer::getPassTimes()
+{
+	this->queryPool.getQueryPoolResults(0);
+
+	std::vector<GpuSortPassTime> passTimes(this->passNames.size());
+	for (uint32_t i = 0; i < uint32_t(this->passNames.size()); ++i)
+	{
+		passTimes[i].passName = this->passNames[i];
+		passTimes[i].ms = static_cast<float>(
+			(this->queryPool.getQueryResult(0, i + 1) - this->queryPool.getQueryResult(0, i)) *
+			GpuProperties::getTimestampPeriod() * 1e-6
+		);
+	}
+
+	return passTimes;
+}
\ No newline at end of file
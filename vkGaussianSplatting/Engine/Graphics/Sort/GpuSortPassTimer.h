@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../Vulkan/QueryPoolArray.h"
+
+struct GpuSortPassTime
+{
+	std::string passName;
+	float ms = 0.0f;
+};
+
+// Timestamps written between the passes of a GpuSort, 
+// so that the time of each pass can be measured separately.
+class GpuSortPassTimer
+{
+private:
+	QueryPoolArray queryPool;
+	std::vector<std::string> passNames;
+
+public:
+	const static uint32_t MAX_NUM_TIMESTAMPS = 128;
+
+	void create(Device& device);
+	void cleanup();
+
+	// Resets the timestamps and writes the one all passes are measured from
+	void begin(CommandBuffer& commandBuffer);
+
+	// Marks the end of a pass, once all previously recorded compute work has finished
+	void markPass(CommandBuffer& commandBuffer, const std::string& passName);
+
+	// Only valid once the command buffer has finished executing
+	std::vector<GpuSortPassTime> getPassTimes();
+};
\ No newline at end of file
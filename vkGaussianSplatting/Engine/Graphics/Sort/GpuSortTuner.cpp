@@ -0,0 +1,210 @@
+#include "pch.h"
+#include "GpuSortTuner.h"
+#include "SortBenchmark.h"
+#include "../GpuProperties.h"
+
+#include <sstream>
+
+std::string GpuSortTuner::getDeviceKey(uint32_t numSortKeyBits, uint32_t numCompactTileBits)
+{
+	return std::to_string(GpuProperties::getVendorID()) + ":" + 
+		std::to_string(GpuProperties::getDeviceID()) + ":" + 
+		std::to_string(GpuProperties::getDriverVersion()) + ":" + 
+		std::to_string(numSortKeyBits) + ":" + 
+		std::to_string(numCompactTileBits);
+}
+
+bool GpuSortTuner::loadCachedConfig(const std::string& cachePath, const std::string& deviceKey, GpuSortConfig& outputConfig)
+{
+	std::ifstream file(cachePath);
+	if (!file)
+		return false;
+
+	// One line per device: <device key> <sort algorithm> <work group size> <sort ms> <device name>
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream lineStream(line);
+		std::string lineDeviceKey;
+		GpuSortConfig config{};
+		if (!(lineStream >> lineDeviceKey >> config.sortAlgorithm >> config.workGroupSize))
+			continue;
+
+		if (lineDeviceKey == deviceKey)
+		{
+			outputConfig = config;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void GpuSortTuner::saveCachedConfig(const std::string& cachePath, const std::string& deviceKey, const GpuSortConfig& config, float sortMs)
+{
+	// Keep the lines of other devices
+	std::vector<std::string> lines;
+	{
+		std::ifstream file(cachePath);
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.rfind(deviceKey + " ", 0) != 0)
+				lines.push_back(line);
+		}
+	}
+	lines.push_back(
+		deviceKey + " " + 
+		std::to_string(config.sortAlgorithm) + " " + 
+		std::to_string(config.workGroupSize) + " " + 
+		std::to_string(sortMs) + " " + 
+		GpuProperties::getDeviceName()
+	);
+
+	const std::filesystem::path parentPath = std::filesystem::path(cachePath).parent_path();
+	if (!parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream file(cachePath);
+	if (!file)
+	{
+		Log::warning("Could not write the sort tuning cache to \"" + cachePath + "\".");
+		return;
+	}
+	for (size_t i = 0; i < lines.size(); ++i)
+		file << lines[i] << "\n";
+}
+
+bool GpuSortTuner::isValidConfig(const GpuSortConfig& config)
+{
+	if (!GpuSortFactory::isSupported(config.sortAlgorithm))
+		return false;
+
+	// The candidates might have changed since the config was cached
+	const std::vector<uint32_t> workGroupSizes = GpuSortFactory::getWorkGroupSizeCandidates(config.sortAlgorithm);
+	return workGroupSizes.empty() ? 
+		config.workGroupSize == 0 :
+		std::find(workGroupSizes.begin(), workGroupSizes.end(), config.workGroupSize) != workGroupSizes.end();
+}
+
+GpuSortConfig GpuSortTuner::tune(
+	const GfxAllocContext& gfxAllocContext,
+	const std::string& deviceKey,
+	uint32_t numTiles,
+	uint32_t numCompactTileBits)
+{
+	Log::write("Tuning the GPU sort for " + GpuProperties::getDeviceName() + "...");
+
+	// Candidate configs
+	std::vector<GpuSortConfig> configs;
+	for (uint32_t sortAlgorithm = 0; sortAlgorithm <= RADIX_SORT; ++sortAlgorithm)
+	{
+		GpuSortConfig config{};
+		config.sortAlgorithm = sortAlgorithm;
+
+		const std::vector<uint32_t> workGroupSizes = GpuSortFactory::getWorkGroupSizeCandidates(sortAlgorithm);
+		if (workGroupSizes.empty() && GpuSortTuner::isValidConfig(config))
+			configs.push_back(config);
+
+		for (size_t i = 0; i < workGroupSizes.size(); ++i)
+		{
+			config.workGroupSize = workGroupSizes[i];
+			if (GpuSortTuner::isValidConfig(config))
+				configs.push_back(config);
+		}
+	}
+
+	SortBenchmarkSettings settings{};
+	settings.numWarmupIterations = 2;
+	settings.numIterations = NUM_TUNING_ITERATIONS;
+	settings.numTiles = numTiles;
+	settings.numCompactTileBits = numCompactTileBits;
+
+	SortBenchmark sortBenchmark;
+	sortBenchmark.init(gfxAllocContext);
+
+	// Spread out keys, and keys crowded into a few tiles like close up splats
+	const std::array<SortBenchmarkDistribution, 2> distributions =
+	{
+		SortBenchmarkDistribution::UNIFORM,
+		SortBenchmarkDistribution::FEW_TILES_HEAVY
+	};
+	std::array<SortBenchmarkKeys, 2> keys;
+	for (size_t d = 0; d < distributions.size(); ++d)
+	{
+		sortBenchmark.generateKeys(
+			distributions[d],
+			NUM_TUNING_SORT_ELEMENTS,
+			settings,
+			SortBenchmarkKeys(),
+			keys[d]
+		);
+	}
+
+	// Fastest config with a valid output, summed over the distributions
+	GpuSortConfig bestConfig{};
+	float bestSortMs = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < configs.size(); ++i)
+	{
+		std::shared_ptr<GpuSort> gpuSort = GpuSortFactory::create(configs[i]);
+		gpuSort->singleInitResources(gfxAllocContext);
+
+		bool isValid = true;
+		float sortMs = 0.0f;
+		for (size_t d = 0; d < distributions.size() && isValid; ++d)
+		{
+			const SortBenchmarkResult result = sortBenchmark.benchmarkSort(
+				GpuSortFactory::toString(configs[i]),
+				*gpuSort,
+				distributions[d],
+				keys[d],
+				settings
+			);
+			isValid = result.isValid;
+			sortMs += result.sortMs;
+		}
+		if (isValid && sortMs < bestSortMs)
+		{
+			bestConfig = configs[i];
+			bestSortMs = sortMs;
+		}
+
+		gpuSort->cleanup();
+	}
+
+	sortBenchmark.cleanup();
+
+	if (bestSortMs == std::numeric_limits<float>::max())
+	{
+		Log::warning("No sort config passed validation while tuning, using the default.");
+		return GpuSortConfig{};
+	}
+
+	GpuSortTuner::saveCachedConfig(CACHE_PATH, deviceKey, bestConfig, bestSortMs);
+
+	return bestConfig;
+}
+
+GpuSortConfig GpuSortTuner::getConfig(
+	const GfxAllocContext& gfxAllocContext,
+	uint32_t numTiles,
+	uint32_t numCompactTileBits)
+{
+	// Tile counts within the same number of key bits share one entry, 
+	// so resizing the window does not retune
+	const std::string deviceKey = GpuSortTuner::getDeviceKey(
+		SortBenchmark::getNumSortKeyBits(numTiles, numCompactTileBits), 
+		numCompactTileBits
+	);
+
+	GpuSortConfig config{};
+	if (!GpuSortTuner::loadCachedConfig(CACHE_PATH, deviceKey, config) || 
+		!GpuSortTuner::isValidConfig(config))
+	{
+		config = GpuSortTuner::tune(gfxAllocContext, deviceKey, numTiles, numCompactTileBits);
+	}
+
+	Log::write("GPU sort: " + GpuSortFactory::toString(config));
+
+	return config;
+}
\ No newline at end of file
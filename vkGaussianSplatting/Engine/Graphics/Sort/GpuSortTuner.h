@@ -0,0 +1,35 @@
+#pragma once
+
+#include "GpuSortFactory.h"
+
+// Picks the fastest sort and work group size for the device on first run, 
+// and caches the winner per device, driver and key layout. Tuning measures the 
+// sort alone on synthetic keys with the renderer's tile count and key bits, 
+// not its effect on the rest of the frame.
+class GpuSortTuner
+{
+private:
+	// Identifies the device, driver and key layout within the cache
+	static std::string getDeviceKey(uint32_t numSortKeyBits, uint32_t numCompactTileBits);
+
+	static bool loadCachedConfig(const std::string& cachePath, const std::string& deviceKey, GpuSortConfig& outputConfig);
+	static void saveCachedConfig(const std::string& cachePath, const std::string& deviceKey, const GpuSortConfig& config, float sortMs);
+
+	static bool isValidConfig(const GpuSortConfig& config);
+	static GpuSortConfig tune(
+		const GfxAllocContext& gfxAllocContext, 
+		const std::string& deviceKey, 
+		uint32_t numTiles, 
+		uint32_t numCompactTileBits);
+
+public:
+	const static uint32_t NUM_TUNING_SORT_ELEMENTS = 1u << 20;
+	const static uint32_t NUM_TUNING_ITERATIONS = 10;
+	inline static const std::string CACHE_PATH = "Resources/SortBenchmark/gpuSortTuningCache.txt";
+
+	// Tunes if the cache has no valid config for the device and key layout
+	static GpuSortConfig getConfig(
+		const GfxAllocContext& gfxAllocContext, 
+		uint32_t numTiles, 
+		uint32_t numCompactTileBits);
+};
\ No newline at end of file
@@ -1,19 +1,9 @@
 #include "pch.h"
 #include "RadixSort.h"
 
-uint32_t RadixSort::getMinNumBits(uint32_t x) const
-{
-	for (int32_t i = 32 - 1; i >= 0; --i)
-	{
-		if (uint32_t(x >> i) & 1)
-			return static_cast<uint32_t>(i + 1);
-	}
-
-	return 0;
-}
-
-RadixSort::RadixSort()
+RadixSort::RadixSort(uint32_t workGroupSize)
 	: gfxAllocContext(nullptr),
+	workGroupSize(workGroupSize),
 	maxNumSortElements(0),
 	radixSortNumSortBits(0)
 {
@@ -38,7 +28,7 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->indirectSetupPipelineLayout,
 		"Resources/Shaders/RadixSortIndirectSetup.comp.spv",
 		{
-			SpecializationConstant{ (void*) RS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
 
@@ -46,6 +36,7 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 	this->countPipelineLayout.createPipelineLayout(
 		*this->gfxAllocContext->device,
 		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
@@ -58,7 +49,7 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->countPipelineLayout,
 		"Resources/Shaders/RadixSortCount.comp.spv",
 		{
-			SpecializationConstant{ (void*) RS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
 
@@ -77,7 +68,7 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->reducePipelineLayout,
 		"Resources/Shaders/RadixSortReduce.comp.spv",
 		{
-			SpecializationConstant{ (void*) RS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
 
@@ -115,7 +106,7 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->scanAddPipelineLayout,
 		"Resources/Shaders/RadixSortScanAdd.comp.spv",
 		{
-			SpecializationConstant{ (void*) RS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
 
@@ -123,6 +114,8 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 	this->scatterPipelineLayout.createPipelineLayout(
 		*this->gfxAllocContext->device,
 		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
 			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
@@ -136,18 +129,20 @@ void RadixSort::singleInitResources(const GfxAllocContext& allocContext)
 		this->scatterPipelineLayout,
 		"Resources/Shaders/RadixSortScatter.comp.spv",
 		{
-			SpecializationConstant{ (void*) RS_WORK_GROUP_SIZE, sizeof(uint32_t)}
+			SpecializationConstant{ (void*) this->workGroupSize, sizeof(uint32_t)}
 		}
 	);
+
+	this->tileRangeScan.singleInitResources(*this->gfxAllocContext);
 }
 
-void RadixSort::initForScene(uint32_t maxNumSortElements, uint32_t numTiles)
+void RadixSort::initForScene(uint32_t maxNumSortElements, uint32_t numSortKeyBits)
 {
 	this->maxNumSortElements = maxNumSortElements;
 
-	uint32_t numCountThreadGroups = (this->maxNumSortElements + RS_WORK_GROUP_SIZE - 1) / RS_WORK_GROUP_SIZE;
+	uint32_t numCountThreadGroups = (this->maxNumSortElements + this->workGroupSize - 1) / this->workGroupSize;
 	uint32_t numSumElements = numCountThreadGroups * RS_BIN_COUNT;
-	uint32_t numReduceBlocks = (numCountThreadGroups + RS_WORK_GROUP_SIZE - 1) / RS_WORK_GROUP_SIZE;
+	uint32_t numReduceBlocks = (numCountThreadGroups + this->workGroupSize - 1) / this->workGroupSize;
 	uint32_t numReduceElements = numReduceBlocks * RS_BIN_COUNT;
 
 	// Indirect dispatch buffer
@@ -178,30 +173,23 @@ void RadixSort::initForScene(uint32_t maxNumSortElements, uint32_t numTiles)
 		dummyReduceData.data()
 	);
 
-	// Ping pong buffer
-	GaussianSortData clearedSortData
-	{ 
-		glm::uvec4(
-			std::numeric_limits<uint32_t>::max(), 
-			std::numeric_limits<uint32_t>::max(), 
-			std::numeric_limits<uint32_t>::max(), 
-			std::numeric_limits<uint32_t>::max()
-		)
-	};
-	std::vector<GaussianSortData> sortData(this->maxNumSortElements, clearedSortData);
+	// Ping pong buffer (same layout as the sort list, never cleared)
 	this->pingPongBuffer = std::make_shared<StorageBuffer>();
 	this->pingPongBuffer->createGpuBuffer(
 		*this->gfxAllocContext,
-		sizeof(sortData[0]) * sortData.size(),
-		sortData.data()
+		GaussianSortList::getBufferSize(this->maxNumSortElements),
+		nullptr
 	);
-	sortData.clear();
-	sortData.shrink_to_fit();
 
-	// Not all of the highest bits in the sorting keys are utilized, 
-	// meaning that sorting only needs to be done for the lowest bits actually being used.
-	uint32_t sortBits = 32 + this->getMinNumBits(numTiles - 1);
-	this->radixSortNumSortBits = uint32_t((sortBits + RS_BITS_PER_PASS - 1) / RS_BITS_PER_PASS) * RS_BITS_PER_PASS;
+	this->radixSortNumSortBits = uint32_t((numSortKeyBits + RS_BITS_PER_PASS - 1) / RS_BITS_PER_PASS) * RS_BITS_PER_PASS;
+}
+
+void RadixSort::setTileRanges(
+	StorageBuffer& tileRangesSBO,
+	uint32_t numTiles,
+	uint32_t numCompactTileBits)
+{
+	this->tileRangeScan.setTileRanges(tileRangesSBO, numTiles, numCompactTileBits);
 }
 
 void RadixSort::computeSort(
@@ -219,7 +207,8 @@ void RadixSort::computeSort(
 
 	// Limitation of the scatter shader
 	assert(RS_BITS_PER_PASS % 2 == 0);
-	assert(RS_WORK_GROUP_SIZE >= RS_BIN_COUNT);
+	assert(this->workGroupSize >= RS_BIN_COUNT);
+	assert(this->tileRangeScan.hasTileRanges());
 
 	// Wait for work on initialization of the sorting list to finish
 	std::array<VkBufferMemoryBarrier2, 3> initBufferBarriers =
@@ -289,6 +278,7 @@ void RadixSort::computeSort(
 
 		// Dispatch
 		commandBuffer.dispatch(1);
+		this->markPass(commandBuffer, "indirect setup");
 	}
 
 	// Wait on dispatch parameters
@@ -302,6 +292,7 @@ void RadixSort::computeSort(
 	);
 
 	SortGaussiansRsPCD sortGaussiansPcData{};
+	sortGaussiansPcData.data.y = this->tileRangeScan.getNumCompactTileBits();
 
 	StorageBuffer* srcSortBuffer = gaussiansSortListSBO.get();
 	StorageBuffer* dstSortBuffer = this->pingPongBuffer.get();
@@ -309,6 +300,7 @@ void RadixSort::computeSort(
 	for (uint32_t shiftBits = 0; shiftBits < this->radixSortNumSortBits; shiftBits += RS_BITS_PER_PASS)
 	{
 		sortGaussiansPcData.data.x = shiftBits;
+		sortGaussiansPcData.data.z = shiftBits == 0 ? 1u : 0u; // Count tiles in the first pass
 
 		// ------------------ 1. Count ------------------
 		{
@@ -321,21 +313,24 @@ void RadixSort::computeSort(
 			inputIndirectDispatchInfo.range = this->indirectDispatchBuffer.getBufferSize();
 
 			// Binding 1
-			VkDescriptorBufferInfo inputGaussiansSortInfo{};
-			inputGaussiansSortInfo.buffer = srcSortBuffer->getVkBuffer();
-			inputGaussiansSortInfo.range = srcSortBuffer->getBufferSize();
+			VkDescriptorBufferInfo inputGaussiansSortKeysInfo = 
+				GpuSort::getSortKeysInfo(*srcSortBuffer, this->maxNumSortElements);
 
 			// Binding 2
 			VkDescriptorBufferInfo outputSumTableInfo{};
 			outputSumTableInfo.buffer = this->sumTableBuffer.getVkBuffer();
 			outputSumTableInfo.range = this->sumTableBuffer.getBufferSize();
 
+			// Binding 3
+			VkDescriptorBufferInfo outputTileCountsInfo = this->tileRangeScan.getTileCountsInfo();
+
 			// Descriptor sets
-			std::array<VkWriteDescriptorSet, 3> countDescriptorSets
+			std::array<VkWriteDescriptorSet, 4> countDescriptorSets
 			{
 				DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputIndirectDispatchInfo),
-				DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortInfo),
-				DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputSumTableInfo)
+				DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortKeysInfo),
+				DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputSumTableInfo),
+				DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputTileCountsInfo)
 			};
 			commandBuffer.pushDescriptorSet(
 				this->countPipelineLayout,
@@ -355,6 +350,14 @@ void RadixSort::computeSort(
 				this->indirectDispatchBuffer.getVkBuffer(), 
 				offsetof(RadixIndirectDispatch, countSizeX)
 			);
+			this->markPass(commandBuffer, "count");
+
+			// The tile counts are complete after the first count pass
+			if (shiftBits == 0)
+			{
+				this->tileRangeScan.computeRanges(commandBuffer);
+				this->markPass(commandBuffer, "tile ranges");
+			}
 		}
 
 		// ------------------ 2. Reduce ------------------
@@ -422,6 +425,7 @@ void RadixSort::computeSort(
 				this->indirectDispatchBuffer.getVkBuffer(), 
 				offsetof(RadixIndirectDispatch, reduceSizeX)
 			);
+			this->markPass(commandBuffer, "reduce");
 		}
 
 		// ------------------ 3. Scan ------------------
@@ -464,6 +468,7 @@ void RadixSort::computeSort(
 
 			// Dispatch
 			commandBuffer.dispatch(1);
+			this->markPass(commandBuffer, "scan");
 		}
 
 		// ------------------ 4. Scan add ------------------
@@ -532,6 +537,7 @@ void RadixSort::computeSort(
 				this->indirectDispatchBuffer.getVkBuffer(), 
 				offsetof(RadixIndirectDispatch, reduceSizeX)
 			);
+			this->markPass(commandBuffer, "scan add");
 		}
 
 		// ------------------ 5. Scatter ------------------
@@ -576,22 +582,30 @@ void RadixSort::computeSort(
 			inputSumTableInfo.range = this->sumTableBuffer.getBufferSize();
 
 			// Binding 2
-			VkDescriptorBufferInfo inputSortSourceInfo{};
-			inputSortSourceInfo.buffer = srcSortBuffer->getVkBuffer();
-			inputSortSourceInfo.range = srcSortBuffer->getBufferSize();
+			VkDescriptorBufferInfo inputSortSourceKeysInfo = 
+				GpuSort::getSortKeysInfo(*srcSortBuffer, this->maxNumSortElements);
 
 			// Binding 3
-			VkDescriptorBufferInfo outputSortDestinationInfo{};
-			outputSortDestinationInfo.buffer = dstSortBuffer->getVkBuffer();
-			outputSortDestinationInfo.range = dstSortBuffer->getBufferSize();
+			VkDescriptorBufferInfo inputSortSourceValuesInfo = 
+				GpuSort::getSortValuesInfo(*srcSortBuffer, this->maxNumSortElements);
+
+			// Binding 4
+			VkDescriptorBufferInfo outputSortDestinationKeysInfo = 
+				GpuSort::getSortKeysInfo(*dstSortBuffer, this->maxNumSortElements);
+
+			// Binding 5
+			VkDescriptorBufferInfo outputSortDestinationValuesInfo = 
+				GpuSort::getSortValuesInfo(*dstSortBuffer, this->maxNumSortElements);
 
 			// Descriptor sets
-			std::array<VkWriteDescriptorSet, 4> scatterDescriptorSets
+			std::array<VkWriteDescriptorSet, 6> scatterDescriptorSets
 			{
 				DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputIndirectDispatchInfo),
 				DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputSumTableInfo),
-				DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputSortSourceInfo),
-				DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputSortDestinationInfo)
+				DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputSortSourceKeysInfo),
+				DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputSortSourceValuesInfo),
+				DescriptorSet::writeBuffer(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputSortDestinationKeysInfo),
+				DescriptorSet::writeBuffer(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputSortDestinationValuesInfo)
 			};
 			commandBuffer.pushDescriptorSet(
 				this->scatterPipelineLayout,
@@ -611,6 +625,7 @@ void RadixSort::computeSort(
 				this->indirectDispatchBuffer.getVkBuffer(), 
 				offsetof(RadixIndirectDispatch, countSizeX)
 			);
+			this->markPass(commandBuffer, "scatter");
 
 			// No matter which shader reads dst next, the shader should wait for dst
 			commandBuffer.bufferMemoryBarrier(
@@ -652,13 +667,21 @@ void RadixSort::computeSort(
 	}
 }
 
-void RadixSort::cleanup()
+void RadixSort::cleanupForScene()
 {
-	this->pingPongBuffer->cleanup();
+	this->tileRangeScan.cleanupForScene();
+	if (this->pingPongBuffer)
+		this->pingPongBuffer->cleanup();
 	this->reduceBuffer.cleanup();
 	this->sumTableBuffer.cleanup();
 	this->indirectDispatchBuffer.cleanup();
+}
 
+void RadixSort::cleanup()
+{
+	this->cleanupForScene();
+
+	this->tileRangeScan.cleanup();
 	this->scatterPipelineLayout.cleanup();
 	this->scatterPipeline.cleanup();
 	this->scanAddPipelineLayout.cleanup();
@@ -675,19 +698,7 @@ void RadixSort::cleanup()
 
 void RadixSort::gpuClearBuffers(CommandBuffer& commandBuffer)
 {
-	// Reset radix sort ping pong buffer, similar to gaussian sort keys
-	commandBuffer.fillBuffer(
-		this->pingPongBuffer->getVkBuffer(),
-		sizeof(GaussianSortData) * this->maxNumSortElements,
-		std::numeric_limits<uint32_t>::max()
-	);
-
-	commandBuffer.bufferMemoryBarrier(
-		VK_ACCESS_TRANSFER_WRITE_BIT,
-		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-		VK_PIPELINE_STAGE_TRANSFER_BIT,
-		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-		this->pingPongBuffer->getVkBuffer(),
-		this->pingPongBuffer->getBufferSize()
-	);
+	// Ping pong keys are not reset, since only the 
+	// first numGaussiansToRender elements are ever read
+	this->tileRangeScan.gpuClearBuffers(commandBuffer);
 }
\ No newline at end of file
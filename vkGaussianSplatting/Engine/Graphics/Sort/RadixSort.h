@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GpuSort.h"
+#include "TileRangeScan.h"
 #include "../Buffer/StorageBuffer.h"
 
 class RadixSort : public GpuSort
@@ -23,30 +24,46 @@ private:
 	StorageBuffer sumTableBuffer;
 	StorageBuffer reduceBuffer;
 	std::shared_ptr<StorageBuffer> pingPongBuffer;
+	TileRangeScan tileRangeScan;
 	std::shared_ptr<StorageBuffer> tempSwapPingPongBuffer;
 
 	const GfxAllocContext* gfxAllocContext;
 
+	uint32_t workGroupSize;
 	uint32_t maxNumSortElements;
 	uint32_t radixSortNumSortBits;
 
-	uint32_t getMinNumBits(uint32_t x) const;
-
 public:
 	const static uint32_t RS_BITS_PER_PASS = 4;
 	const static uint32_t RS_BIN_COUNT = 1u << RS_BITS_PER_PASS;
 	const static uint32_t RS_WORK_GROUP_SIZE = 64; // 128 saves 0.5 ms on sorting, but seems to worsen rendering timings by 1 ms (before rendering optimization).
 	const static uint32_t RS_SCAN_WORK_GROUP_SIZE = 1024;
+	const static uint32_t RS_TILE_COUNT_SLOTS = 64; // Matches TILE_COUNT_SLOTS in RadixSortCount.comp
+
+	// Shared memory of the count pass, the largest of all passes
+	static inline uint32_t getSharedMemorySize(uint32_t workGroupSize) 
+	{ 
+		return (workGroupSize * RS_BIN_COUNT + RS_TILE_COUNT_SLOTS * 2) * sizeof(uint32_t); 
+	}
 
-	RadixSort();
+	// Work group size of every pass except the scan
+	RadixSort(uint32_t workGroupSize = RS_WORK_GROUP_SIZE);
 
 	virtual void singleInitResources(const GfxAllocContext& allocContext) override;
-	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numTiles) override;
+	virtual void initForScene(uint32_t maxNumSortElements, uint32_t numSortKeyBits) override;
 	virtual void computeSort(
 		CommandBuffer& commandBuffer,
 		StorageBuffer& gaussiansCullDataSBO,
 		std::shared_ptr<StorageBuffer>& gaussiansSortListSBO) override;
+	virtual void cleanupForScene() override;
 	virtual void cleanup() override;
 
 	virtual void gpuClearBuffers(CommandBuffer& commandBuffer) override;
+
+	inline virtual bool writesTileRanges() const override { return true; }
+	inline virtual bool sortsLivePrefixOnly() const override { return true; }
+	virtual void setTileRanges(
+		StorageBuffer& tileRangesSBO,
+		uint32_t numTiles,
+		uint32_t numCompactTileBits) override;
 };
\ No newline at end of file
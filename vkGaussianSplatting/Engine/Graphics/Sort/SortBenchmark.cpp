@@ -0,0 +1,467 @@
+#include "pch.h"
+#include "SortBenchmark.h"
+#include "SortValidator.h"
+#include "GpuSortFactory.h"
+#include "../Buffer/StorageBuffer.h"
+#include "../Buffer/ReadbackBuffer.h"
+
+#include <random>
+
+struct SortBenchmarkKeysHeader
+{
+	uint32_t numKeys;
+	uint32_t numSortKeyBits;
+	uint32_t numTiles;
+	uint32_t numCompactTileBits;
+};
+
+struct SortBenchmarkPassResult
+{
+	std::string passName;
+	float totalMs = 0.0f;
+	uint32_t numPasses = 0; // Within all iterations
+};
+
+uint32_t SortBenchmark::getCeilPowTwo(uint32_t x)
+{
+	uint32_t powTwo = 1;
+	while (powTwo < x)
+		powTwo *= 2;
+
+	return powTwo;
+}
+
+uint32_t SortBenchmark::getNumSortKeyBits(uint32_t numTiles, uint32_t numCompactTileBits)
+{
+	if (numCompactTileBits > 0)
+		return 32;
+
+	uint32_t numTileBits = 1;
+	while ((1u << numTileBits) < numTiles)
+		numTileBits++;
+
+	return 32 + numTileBits;
+}
+
+const char* SortBenchmark::toString(SortBenchmarkDistribution distribution)
+{
+	switch (distribution)
+	{
+	case SortBenchmarkDistribution::UNIFORM:			return "uniform";
+	case SortBenchmarkDistribution::CAPTURED:			return "captured";
+	case SortBenchmarkDistribution::FEW_TILES_HEAVY:	return "few tiles heavy";
+	case SortBenchmarkDistribution::SORTED:				return "sorted";
+	case SortBenchmarkDistribution::REVERSE_SORTED:		return "reverse sorted";
+	}
+
+	return "unknown";
+}
+
+bool SortBenchmark::generateKeys(
+	SortBenchmarkDistribution distribution,
+	uint32_t numSortElements,
+	const SortBenchmarkSettings& settings,
+	const SortBenchmarkKeys& capturedKeys,
+	SortBenchmarkKeys& outputKeys) const
+{
+	outputKeys.keys.resize(numSortElements);
+
+	// Captured keys keep the layout of the scene they were captured from
+	if (distribution == SortBenchmarkDistribution::CAPTURED)
+	{
+		if (capturedKeys.keys.empty())
+			return false;
+
+		for (uint32_t i = 0; i < numSortElements; ++i)
+			outputKeys.keys[i] = capturedKeys.keys[i % capturedKeys.keys.size()];
+		outputKeys.numSortKeyBits = capturedKeys.numSortKeyBits;
+		outputKeys.numTiles = capturedKeys.numTiles;
+		outputKeys.numCompactTileBits = capturedKeys.numCompactTileBits;
+
+		return true;
+	}
+
+	// Keys laid out like InitSortList writes them
+	const uint32_t numCompactTileBits = settings.numCompactTileBits;
+	outputKeys.numSortKeyBits = SortBenchmark::getNumSortKeyBits(settings.numTiles, numCompactTileBits);
+	outputKeys.numTiles = settings.numTiles;
+	outputKeys.numCompactTileBits = numCompactTileBits;
+
+	// Same keys for every sort
+	std::mt19937 randomEngine(numSortElements);
+	const uint32_t heavyTileIndex = settings.numTiles / 2;
+	const uint32_t numHeavyTiles = std::min(4u, settings.numTiles - heavyTileIndex);
+	for (uint32_t i = 0; i < numSortElements; ++i)
+	{
+		uint32_t tileIndex = randomEngine() % settings.numTiles;
+		const uint32_t depthKey = randomEngine();
+
+		// 90% of the elements within a few tiles
+		if (distribution == SortBenchmarkDistribution::FEW_TILES_HEAVY && randomEngine() % 10 != 0)
+			tileIndex = heavyTileIndex + randomEngine() % numHeavyTiles;
+
+		outputKeys.keys[i] = numCompactTileBits > 0 ? 
+			uint64_t((tileIndex << (32 - numCompactTileBits)) | (depthKey >> numCompactTileBits)) : 
+			(uint64_t(tileIndex) << 32) | uint64_t(depthKey);
+	}
+
+	if (distribution == SortBenchmarkDistribution::SORTED)
+		std::sort(outputKeys.keys.begin(), outputKeys.keys.end());
+	else if (distribution == SortBenchmarkDistribution::REVERSE_SORTED)
+		std::sort(outputKeys.keys.begin(), outputKeys.keys.end(), std::greater<uint64_t>());
+
+	return true;
+}
+
+SortBenchmarkResult SortBenchmark::benchmarkSort(
+	const std::string& sortName,
+	GpuSort& gpuSort,
+	SortBenchmarkDistribution distribution,
+	const SortBenchmarkKeys& keys,
+	const SortBenchmarkSettings& settings)
+{
+	const uint32_t numSortElements = uint32_t(keys.keys.size());
+	const uint32_t maxNumSortElements = std::max(SortBenchmark::getCeilPowTwo(numSortElements), MIN_SORT_ELEMENTS);
+
+	// Unsorted list, copied into the sort list before every iteration
+	std::vector<uint64_t> unsortedKeys(maxNumSortElements, ~uint64_t(0));
+	std::vector<uint32_t> unsortedValues(maxNumSortElements, 0u);
+	for (uint32_t i = 0; i < numSortElements; ++i)
+	{
+		unsortedKeys[i] = keys.keys[i];
+		unsortedValues[i] = i;
+	}
+	std::vector<uint8_t> unsortedListData(GaussianSortList::getBufferSize(maxNumSortElements));
+	std::memcpy(
+		unsortedListData.data(),
+		unsortedKeys.data(),
+		GaussianSortList::getKeysSize(maxNumSortElements)
+	);
+	std::memcpy(
+		unsortedListData.data() + GaussianSortList::getValuesOffset(maxNumSortElements),
+		unsortedValues.data(),
+		GaussianSortList::getValuesSize(maxNumSortElements)
+	);
+
+	StorageBuffer unsortedListBuffer;
+	unsortedListBuffer.createGpuBuffer(
+		*this->gfxAllocContext,
+		unsortedListData.size(),
+		unsortedListData.data()
+	);
+
+	std::shared_ptr<StorageBuffer> sortListBuffer = std::make_shared<StorageBuffer>();
+	sortListBuffer->createGpuBuffer(
+		*this->gfxAllocContext,
+		unsortedListData.size(),
+		nullptr
+	);
+
+	GaussianCullData cullData{};
+	cullData.numGaussiansToRender.x = numSortElements;
+	cullData.numGaussiansToRender.y = maxNumSortElements;
+	StorageBuffer cullDataBuffer;
+	cullDataBuffer.createGpuBuffer(
+		*this->gfxAllocContext,
+		sizeof(GaussianCullData),
+		&cullData
+	);
+
+	const std::vector<GaussianTileRangeData> initTileRanges(keys.numTiles);
+	StorageBuffer tileRangesBuffer;
+	tileRangesBuffer.createGpuBuffer(
+		*this->gfxAllocContext,
+		sizeof(initTileRanges[0]) * initTileRanges.size(),
+		initTileRanges.data()
+	);
+
+	ReadbackBuffer sortedReadback;
+	sortedReadback.createReadbackBuffer(
+		*this->gfxAllocContext,
+		unsortedListData.size(),
+		1
+	);
+
+	gpuSort.initForScene(maxNumSortElements, keys.numSortKeyBits);
+	if (gpuSort.writesTileRanges())
+		gpuSort.setTileRanges(tileRangesBuffer, keys.numTiles, keys.numCompactTileBits);
+	gpuSort.setPassTimer(&this->passTimer);
+
+	std::vector<SortBenchmarkPassResult> passResults;
+	const uint32_t numTotalIterations = settings.numWarmupIterations + settings.numIterations;
+	for (uint32_t iteration = 0; iteration < numTotalIterations; ++iteration)
+	{
+		const bool isLastIteration = iteration == numTotalIterations - 1;
+
+		CommandBuffer commandBuffer;
+		commandBuffer.init(*this->gfxAllocContext->device);
+		commandBuffer.beginSingleTimeUse(*this->gfxAllocContext);
+
+		// Same steps as a frame, where InitSortList writes the list
+		commandBuffer.copyBuffer(
+			unsortedListBuffer.getVkBuffer(),
+			sortListBuffer->getVkBuffer(),
+			unsortedListData.size()
+		);
+		commandBuffer.bufferMemoryBarrier(
+			VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			sortListBuffer->getVkBuffer(),
+			sortListBuffer->getBufferSize()
+		);
+		gpuSort.gpuClearBuffers(commandBuffer);
+
+		this->passTimer.begin(commandBuffer);
+		gpuSort.computeSort(commandBuffer, cullDataBuffer, sortListBuffer);
+
+		if (isLastIteration)
+		{
+			commandBuffer.bufferMemoryBarrier(
+				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+				VK_ACCESS_TRANSFER_READ_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				sortListBuffer->getVkBuffer(),
+				sortListBuffer->getBufferSize()
+			);
+			commandBuffer.copyBuffer(
+				sortListBuffer->getVkBuffer(),
+				sortedReadback.getVkBuffer(0),
+				unsortedListData.size()
+			);
+			commandBuffer.bufferMemoryBarrier(
+				VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_ACCESS_HOST_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_HOST_BIT,
+				sortedReadback.getVkBuffer(0),
+				sortedReadback.getBufferSize()
+			);
+		}
+
+		// Waits for the queue to be idle
+		commandBuffer.endSingleTimeUse(*this->gfxAllocContext);
+
+		if (iteration < settings.numWarmupIterations)
+			continue;
+
+		// Passes with the same name are summed, in the order they first appeared
+		const std::vector<GpuSortPassTime> passTimes = this->passTimer.getPassTimes();
+		for (size_t i = 0; i < passTimes.size(); ++i)
+		{
+			auto passResult = std::find_if(
+				passResults.begin(),
+				passResults.end(),
+				[&](const SortBenchmarkPassResult& result) { return result.passName == passTimes[i].passName; }
+			);
+			if (passResult == passResults.end())
+			{
+				passResults.push_back({ passTimes[i].passName });
+				passResult = passResults.end() - 1;
+			}
+
+			passResult->totalMs += passTimes[i].ms;
+			passResult->numPasses++;
+		}
+	}
+
+	gpuSort.setPassTimer(nullptr);
+
+	// Verify the last iteration
+	const uint8_t* sortedData = static_cast<const uint8_t*>(sortedReadback.getMappedData(0));
+	float cpuSortMs = 0.0f;
+	const bool isValid = SortValidator::validate(
+		unsortedKeys.data(),
+		unsortedValues.data(),
+		reinterpret_cast<const uint64_t*>(sortedData),
+		reinterpret_cast<const uint32_t*>(sortedData + GaussianSortList::getValuesOffset(maxNumSortElements)),
+		numSortElements,
+		gpuSort.sortsLivePrefixOnly() ? numSortElements : maxNumSortElements,
+		keys.numSortKeyBits,
+		cpuSortMs
+	);
+
+	// Report averages per iteration
+	const double listGigabytes =
+		double(numSortElements) * (GaussianSortList::KEY_SIZE + GaussianSortList::VALUE_SIZE) * 1e-9;
+	auto getMillionElementsPerSecond = [&](float ms)
+	{
+		return ms > 0.0f ? float(numSortElements / (ms * 1000.0f)) : 0.0f;
+	};
+
+	float sortMs = 0.0f;
+	for (size_t i = 0; i < passResults.size(); ++i)
+		sortMs += passResults[i].totalMs / float(settings.numIterations);
+
+	Log::write(
+		sortName + ", " + SortBenchmark::toString(distribution) + ", " +
+		std::to_string(numSortElements) + " elements (" + std::to_string(keys.numSortKeyBits) + " key bits): " +
+		std::to_string(sortMs) + " ms, " + std::to_string(getMillionElementsPerSecond(sortMs)) + " M elements/s, " +
+		(isValid ? "verified" : "FAILED verification") + ". CPU sort ms: " + std::to_string(cpuSortMs)
+	);
+	for (size_t i = 0; i < passResults.size(); ++i)
+	{
+		const float passMs = passResults[i].totalMs / float(settings.numIterations);
+		const float numPassesPerSort = float(passResults[i].numPasses) / float(settings.numIterations);
+		const double passGigabytesPerSecond =
+			passMs > 0.0f ? 2.0 * listGigabytes * numPassesPerSort / (passMs * 1e-3) : 0.0;
+
+		Log::write(
+			"    " + passResults[i].passName + " (x" + std::to_string(uint32_t(numPassesPerSort)) + "): " +
+			std::to_string(passMs) + " ms, " +
+			std::to_string(getMillionElementsPerSecond(passMs / numPassesPerSort)) + " M elements/s, " +
+			std::to_string(passGigabytesPerSecond) + " GB/s"
+		);
+	}
+
+	gpuSort.cleanupForScene();
+	sortedReadback.cleanup();
+	tileRangesBuffer.cleanup();
+	cullDataBuffer.cleanup();
+	sortListBuffer->cleanup();
+	unsortedListBuffer.cleanup();
+
+	SortBenchmarkResult result{};
+	result.sortMs = sortMs;
+	result.isValid = isValid;
+	return result;
+}
+
+SortBenchmark::SortBenchmark()
+	: gfxAllocContext(nullptr)
+{
+}
+
+void SortBenchmark::init(const GfxAllocContext& gfxAllocContext)
+{
+	this->gfxAllocContext = &gfxAllocContext;
+	this->passTimer.create(*this->gfxAllocContext->device);
+}
+
+void SortBenchmark::cleanup()
+{
+	this->passTimer.cleanup();
+}
+
+void SortBenchmark::run(const SortBenchmarkSettings& settings)
+{
+	SortBenchmarkKeys capturedKeys;
+	if (!SortBenchmark::loadKeys(settings.capturedKeysPath, capturedKeys))
+	{
+		Log::warning(
+			"No captured sort keys at \"" + settings.capturedKeysPath + "\", skipping the captured distribution. " +
+			"Keys are captured by running a scene with VALIDATE_GPU_SORT."
+		);
+	}
+
+	const std::array<SortBenchmarkDistribution, 5> distributions =
+	{
+		SortBenchmarkDistribution::UNIFORM,
+		SortBenchmarkDistribution::CAPTURED,
+		SortBenchmarkDistribution::FEW_TILES_HEAVY,
+		SortBenchmarkDistribution::SORTED,
+		SortBenchmarkDistribution::REVERSE_SORTED
+	};
+
+	// Every sort the device supports, with each of its work group sizes
+	std::vector<GpuSortConfig> configs;
+	for (uint32_t sortAlgorithm = 0; sortAlgorithm <= RADIX_SORT; ++sortAlgorithm)
+	{
+		if (!GpuSortFactory::isSupported(sortAlgorithm))
+			continue;
+
+		GpuSortConfig config{};
+		config.sortAlgorithm = sortAlgorithm;
+
+		const std::vector<uint32_t> workGroupSizes = GpuSortFactory::getWorkGroupSizeCandidates(sortAlgorithm);
+		if (workGroupSizes.empty())
+			configs.push_back(config);
+
+		for (size_t i = 0; i < workGroupSizes.size(); ++i)
+		{
+			config.workGroupSize = workGroupSizes[i];
+			configs.push_back(config);
+		}
+	}
+
+	uint32_t numRuns = 0;
+	uint32_t numFailedRuns = 0;
+	SortBenchmarkKeys keys;
+	for (size_t c = 0; c < configs.size(); ++c)
+	{
+		std::shared_ptr<GpuSort> gpuSort = GpuSortFactory::create(configs[c]);
+		gpuSort->singleInitResources(*this->gfxAllocContext);
+
+		for (size_t d = 0; d < distributions.size(); ++d)
+		{
+			for (size_t n = 0; n < settings.numSortElements.size(); ++n)
+			{
+				if (!this->generateKeys(distributions[d], settings.numSortElements[n], settings, capturedKeys, keys))
+					continue;
+
+				const SortBenchmarkResult result = 
+					this->benchmarkSort(GpuSortFactory::toString(configs[c]), *gpuSort, distributions[d], keys, settings);
+				numRuns++;
+				numFailedRuns += result.isValid ? 0 : 1;
+			}
+		}
+
+		gpuSort->cleanup();
+	}
+
+	if (numFailedRuns > 0)
+		Log::error(std::to_string(numFailedRuns) + " of " + std::to_string(numRuns) + " sort benchmark runs FAILED verification.");
+	else
+		Log::write("All " + std::to_string(numRuns) + " sort benchmark runs were verified.");
+}
+
+void SortBenchmark::saveKeys(const std::string& filePath, const SortBenchmarkKeys& keys)
+{
+	const std::filesystem::path parentPath = std::filesystem::path(filePath).parent_path();
+	if (!parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file)
+	{
+		Log::warning("Could not write sort keys to \"" + filePath + "\".");
+		return;
+	}
+
+	SortBenchmarkKeysHeader header{};
+	header.numKeys = uint32_t(keys.keys.size());
+	header.numSortKeyBits = keys.numSortKeyBits;
+	header.numTiles = keys.numTiles;
+	header.numCompactTileBits = keys.numCompactTileBits;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(keys.keys.data()), sizeof(keys.keys[0]) * keys.keys.size());
+}
+
+bool SortBenchmark::loadKeys(const std::string& filePath, SortBenchmarkKeys& outputKeys)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	SortBenchmarkKeysHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || header.numKeys == 0)
+		return false;
+
+	outputKeys.keys.resize(header.numKeys);
+	file.read(reinterpret_cast<char*>(outputKeys.keys.data()), sizeof(outputKeys.keys[0]) * outputKeys.keys.size());
+	if (!file)
+	{
+		Log::warning("Sort keys in \"" + filePath + "\" are incomplete.");
+		outputKeys.keys.clear();
+		return false;
+	}
+
+	outputKeys.numSortKeyBits = header.numSortKeyBits;
+	outputKeys.numTiles = header.numTiles;
+	outputKeys.numCompactTileBits = header.numCompactTileBits;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "GpuSortPassTimer.h"
+
+class GpuSort;
+
+enum class SortBenchmarkDistribution
+{
+	UNIFORM,			// Uniform tiles and depths
+	CAPTURED,			// Keys captured from a scene by VALIDATE_GPU_SORT, resampled to the size
+	FEW_TILES_HEAVY,	// Most elements within a few tiles, like a close up splat
+	SORTED,
+	REVERSE_SORTED
+};
+
+struct SortBenchmarkSettings
+{
+	std::vector<uint32_t> numSortElements = { 1u << 18, 1u << 20, 1u << 22 };
+	uint32_t numWarmupIterations = 5;
+	uint32_t numIterations = 20;
+	uint32_t numTiles = 80 * 45; // 1280x720 with 16x16 tiles
+	uint32_t numCompactTileBits = 0; // Packs the synthetic keys into 32 bits like COMPACT_SORT_KEYS, if > 0
+	std::string capturedKeysPath = "Resources/SortBenchmark/capturedSortKeys.bin";
+};
+
+struct SortBenchmarkResult
+{
+	float sortMs = 0.0f; // Average over the iterations
+	bool isValid = false;
+};
+
+struct SortBenchmarkKeys
+{
+	std::vector<uint64_t> keys;
+	uint32_t numSortKeyBits = 0;
+	uint32_t numTiles = 0;
+	uint32_t numCompactTileBits = 0;
+};
+
+// Runs every GpuSort on synthetic keys, outside of rendering. Reports the time of
+// each pass, elements per second and an effective bandwidth, assuming that
+// each pass reads and writes the keys and values once. The output of the
+// last iteration is verified against CpuSort.
+class SortBenchmark
+{
+private:
+	GpuSortPassTimer passTimer;
+
+	const GfxAllocContext* gfxAllocContext;
+
+	static uint32_t getCeilPowTwo(uint32_t x);
+	static const char* toString(SortBenchmarkDistribution distribution);
+
+public:
+	const static uint32_t MIN_SORT_ELEMENTS = 1u << 16;
+
+	SortBenchmark();
+
+	void init(const GfxAllocContext& gfxAllocContext);
+	void cleanup();
+
+	// Benchmarks every sort supported by the device, at each of its work group sizes
+	void run(const SortBenchmarkSettings& settings);
+
+	// Key bits the synthetic keys use, matching Renderer::getNumSortKeyBits()
+	static uint32_t getNumSortKeyBits(uint32_t numTiles, uint32_t numCompactTileBits);
+
+	// Returns false if the distribution has no keys, like CAPTURED before any keys are captured
+	bool generateKeys(
+		SortBenchmarkDistribution distribution,
+		uint32_t numSortElements,
+		const SortBenchmarkSettings& settings,
+		const SortBenchmarkKeys& capturedKeys,
+		SortBenchmarkKeys& outputKeys) const;
+
+	// Expects singleInitResources() to have been called on the sort
+	SortBenchmarkResult benchmarkSort(
+		const std::string& sortName,
+		GpuSort& gpuSort,
+		SortBenchmarkDistribution distribution,
+		const SortBenchmarkKeys& keys,
+		const SortBenchmarkSettings& settings);
+
+	// Keys with the sort list layout, read by the CAPTURED distribution
+	static void saveKeys(const std::string& filePath, const SortBenchmarkKeys& keys);
+	static bool loadKeys(const std::string& filePath, SortBenchmarkKeys& outputKeys);
+};
\ No newline at end of file
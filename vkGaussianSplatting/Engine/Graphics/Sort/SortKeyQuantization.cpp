@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "SortKeyQuantization.h"
+
+SortKeyQuantizationStats SortKeyQuantization::measure(
+	const uint64_t* unsortedKeys,
+	uint32_t numSortElements,
+	uint32_t numTileBits)
+{
+	SortKeyQuantizationStats stats{};
+	stats.numSortElements = numSortElements;
+
+	// (compact key, full key), in the order InitSortList added them
+	std::vector<std::pair<uint64_t, uint64_t>> keys(numSortElements);
+	for (uint32_t i = 0; i < numSortElements; ++i)
+		keys[i] = { SortKeyQuantization::getCompactKey(unsortedKeys[i], numTileBits), unsortedKeys[i] };
+
+	std::stable_sort(
+		keys.begin(), 
+		keys.end(), 
+		[](const std::pair<uint64_t, uint64_t>& a, const std::pair<uint64_t, uint64_t>& b)
+		{
+			return a.first < b.first;
+		}
+	);
+
+	for (uint32_t i = 1; i < numSortElements; ++i)
+	{
+		const uint64_t prevFullKey = keys[i - 1].second;
+		const uint64_t fullKey = keys[i].second;
+
+		// Only splats within the same tile are blended together
+		if ((prevFullKey >> 32) != (fullKey >> 32))
+			continue;
+		stats.numOverlappingPairs++;
+
+		if (keys[i - 1].first == keys[i].first && prevFullKey != fullKey)
+			stats.numTiedPairs++;
+
+		// Farther splat before a closer splat
+		if (prevFullKey > fullKey)
+			stats.numReorderedPairs++;
+	}
+
+	return stats;
+}
+
+std::string SortKeyQuantization::toString(const SortKeyQuantizationStats& stats)
+{
+	const float reorderedPercent = 
+		stats.numOverlappingPairs > 0 ? 
+		100.0f * float(stats.numReorderedPairs) / float(stats.numOverlappingPairs) : 
+		0.0f;
+
+	return 
+		"Compact key quantization (" + std::to_string(stats.numSortElements) + " elements): " + 
+		std::to_string(stats.numReorderedPairs) + "/" + std::to_string(stats.numOverlappingPairs) + 
+		" overlapping pairs reordered (" + std::to_string(reorderedPercent) + "%), " + 
+		std::to_string(stats.numTiedPairs) + " pairs tied.";
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+struct SortKeyQuantizationStats
+{
+	uint32_t numSortElements = 0;
+	uint32_t numOverlappingPairs = 0;	// Neighbouring splats within the same tile
+	uint32_t numTiedPairs = 0;			// Distinct depths, but equal quantized depths
+	uint32_t numReorderedPairs = 0;		// Drawn in the wrong order after sorting compact keys
+};
+
+// CPU tool measuring how the depth quantization of compact sort keys 
+// affects the drawing order of splats overlapping the same tile.
+class SortKeyQuantization
+{
+public:
+	// Mirrors getSortKey() in InitSortList.comp
+	static inline uint64_t getCompactKey(uint64_t fullKey, uint32_t numTileBits)
+	{
+		const uint32_t tileKey = uint32_t(fullKey >> 32);
+		const uint32_t depthKey = uint32_t(fullKey);
+
+		return uint64_t((tileKey << (32 - numTileBits)) | (depthKey >> numTileBits));
+	}
+
+	// Sorts the full 64-bit keys of an unsorted list with both key types, the same way a 
+	// stable GPU sort would, and compares the resulting order of each tile.
+	static SortKeyQuantizationStats measure(
+		const uint64_t* unsortedKeys, 
+		uint32_t numSortElements, 
+		uint32_t numTileBits);
+
+	static std::string toString(const SortKeyQuantizationStats& stats);
+};
\ No newline at end of file
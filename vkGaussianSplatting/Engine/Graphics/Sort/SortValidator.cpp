@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "SortValidator.h"
+#include "SortKeyQuantization.h"
+#include "CpuSort.h"
+#include "SortBenchmark.h"
+#include "../Buffer/StorageBuffer.h"
+
+void SortValidator::recordCopy(
+	CommandBuffer& commandBuffer,
+	const StorageBuffer& srcBuffer,
+	const ReadbackBuffer& dstBuffer,
+	VkDeviceSize size)
+{
+	// Wait for the compute passes writing to the source
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_TRANSFER_READ_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		srcBuffer.getVkBuffer(),
+		srcBuffer.getBufferSize()
+	);
+
+	commandBuffer.copyBuffer(
+		srcBuffer.getVkBuffer(),
+		dstBuffer.getVkBuffer(0),
+		size
+	);
+
+	// Later compute passes might write to the source again
+	std::array<VkBufferMemoryBarrier2, 2> copyMemoryBarriers
+	{
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_TRANSFER_READ_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			srcBuffer.getVkBuffer(),
+			srcBuffer.getBufferSize()
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_ACCESS_HOST_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_HOST_BIT,
+			dstBuffer.getVkBuffer(0),
+			dstBuffer.getBufferSize()
+		)
+	};
+	commandBuffer.bufferMemoryBarrier(
+		copyMemoryBarriers.data(),
+		(uint32_t) copyMemoryBarriers.size()
+	);
+}
+
+bool SortValidator::validate(
+	const uint64_t* unsortedKeys,
+	const uint32_t* unsortedValues,
+	const uint64_t* sortedKeys,
+	const uint32_t* sortedValues,
+	uint32_t numSortElements,
+	uint32_t numSortedListElements,
+	uint32_t numSortKeyBits,
+	float& cpuSortMs)
+{
+	const CpuSortResult reference = 
+		CpuSort::sort(unsortedKeys, unsortedValues, numSortElements, numSortKeyBits);
+	cpuSortMs = reference.sortMs;
+
+	// Keys have to match the reference, and unused keys have to stay at the end
+	for (uint32_t i = 0; i < numSortedListElements; ++i)
+	{
+		const uint64_t expectedKey = i < numSortElements ? reference.keys[i] : ~uint64_t(0);
+		if (sortedKeys[i] != expectedKey)
+		{
+			Log::warning(
+				"Sort validation: key " + std::to_string(sortedKeys[i]) + " at index " + std::to_string(i) + 
+				", expected " + std::to_string(expectedKey)
+			);
+			return false;
+		}
+	}
+
+	// Values within equal keys are compared as sets, 
+	// so that sorts which are not stable can be validated as well
+	std::vector<uint32_t> referenceRunValues;
+	std::vector<uint32_t> gpuRunValues;
+	for (uint32_t runBegin = 0; runBegin < numSortElements;)
+	{
+		uint32_t runEnd = runBegin + 1;
+		while (runEnd < numSortElements && sortedKeys[runEnd] == sortedKeys[runBegin])
+			runEnd++;
+
+		referenceRunValues.assign(reference.values.begin() + runBegin, reference.values.begin() + runEnd);
+		gpuRunValues.assign(sortedValues + runBegin, sortedValues + runEnd);
+		std::sort(referenceRunValues.begin(), referenceRunValues.end());
+		std::sort(gpuRunValues.begin(), gpuRunValues.end());
+		if (referenceRunValues != gpuRunValues)
+		{
+			Log::warning(
+				"Sort validation: values of key " + std::to_string(sortedKeys[runBegin]) + 
+				" differ from the reference at index " + std::to_string(runBegin)
+			);
+			return false;
+		}
+
+		runBegin = runEnd;
+	}
+
+	return true;
+}
+
+SortValidator::SortValidator()
+	: maxNumSortElements(0),
+	numSortKeyBits(0),
+	numTileBits(0),
+	measureQuantization(false),
+	sortsLivePrefixOnly(false),
+	hasCapturedKeys(false),
+	pendingFrameIndex(NO_PENDING_FRAME),
+	numFramesUntilValidation(0),
+	numValidations(0),
+	numFailedValidations(0)
+{
+}
+
+void SortValidator::create(
+	const GfxAllocContext& gfxAllocContext, 
+	uint32_t maxNumSortElements, 
+	uint32_t numSortKeyBits, 
+	uint32_t numTileBits, 
+	bool measureQuantization,
+	bool sortsLivePrefixOnly)
+{
+	this->maxNumSortElements = maxNumSortElements;
+	this->numSortKeyBits = numSortKeyBits;
+	this->numTileBits = numTileBits;
+	this->measureQuantization = measureQuantization;
+	this->sortsLivePrefixOnly = sortsLivePrefixOnly;
+	this->pendingFrameIndex = NO_PENDING_FRAME;
+
+	// Only one frame is validated at a time
+	this->unsortedReadback.createReadbackBuffer(
+		gfxAllocContext, 
+		GaussianSortList::getBufferSize(maxNumSortElements),
+		1
+	);
+	this->sortedReadback.createReadbackBuffer(
+		gfxAllocContext, 
+		GaussianSortList::getBufferSize(maxNumSortElements),
+		1
+	);
+	this->cullDataReadback.createReadbackBuffer(
+		gfxAllocContext, 
+		sizeof(GaussianCullData),
+		1
+	);
+}
+
+void SortValidator::cleanup()
+{
+	this->cullDataReadback.cleanup();
+	this->sortedReadback.cleanup();
+	this->unsortedReadback.cleanup();
+
+	this->pendingFrameIndex = NO_PENDING_FRAME;
+}
+
+bool SortValidator::beginFrame(uint32_t frameIndex)
+{
+	if (this->pendingFrameIndex != NO_PENDING_FRAME)
+		return false;
+
+	if (this->numFramesUntilValidation > 0)
+	{
+		this->numFramesUntilValidation--;
+		return false;
+	}
+
+	this->numFramesUntilValidation = VALIDATION_INTERVAL;
+	this->pendingFrameIndex = frameIndex;
+	return true;
+}
+
+void SortValidator::recordUnsortedCopy(CommandBuffer& commandBuffer, const StorageBuffer& sortList)
+{
+	this->recordCopy(
+		commandBuffer, 
+		sortList, 
+		this->unsortedReadback, 
+		GaussianSortList::getBufferSize(this->maxNumSortElements)
+	);
+}
+
+void SortValidator::recordSortedCopy(
+	CommandBuffer& commandBuffer,
+	const StorageBuffer& sortList,
+	const StorageBuffer& cullData)
+{
+	this->recordCopy(
+		commandBuffer, 
+		sortList, 
+		this->sortedReadback, 
+		GaussianSortList::getBufferSize(this->maxNumSortElements)
+	);
+	this->recordCopy(
+		commandBuffer, 
+		cullData, 
+		this->cullDataReadback, 
+		sizeof(GaussianCullData)
+	);
+}
+
+void SortValidator::validatePendingFrame(uint32_t frameIndex)
+{
+	if (this->pendingFrameIndex != frameIndex)
+		return;
+	this->pendingFrameIndex = NO_PENDING_FRAME;
+
+	const GaussianCullData* cullData = static_cast<const GaussianCullData*>(this->cullDataReadback.getMappedData(0));
+	const uint8_t* unsortedData = static_cast<const uint8_t*>(this->unsortedReadback.getMappedData(0));
+	const uint8_t* sortedData = static_cast<const uint8_t*>(this->sortedReadback.getMappedData(0));
+
+	// Elements beyond the capacity were dropped by InitSortList
+	const uint32_t numSortElements = std::min(cullData->numGaussiansToRender.x, cullData->numGaussiansToRender.y);
+	const size_t valuesOffset = size_t(GaussianSortList::getValuesOffset(this->maxNumSortElements));
+
+	float cpuSortMs = 0.0f;
+	const bool isValid = SortValidator::validate(
+		reinterpret_cast<const uint64_t*>(unsortedData),
+		reinterpret_cast<const uint32_t*>(unsortedData + valuesOffset),
+		reinterpret_cast<const uint64_t*>(sortedData),
+		reinterpret_cast<const uint32_t*>(sortedData + valuesOffset),
+		numSortElements,
+		this->sortsLivePrefixOnly ? numSortElements : this->maxNumSortElements,
+		this->numSortKeyBits,
+		cpuSortMs
+	);
+
+	this->numValidations++;
+	if (!isValid)
+		this->numFailedValidations++;
+
+	Log::write(
+		"Sort validation (" + std::to_string(numSortElements) + " elements): " + 
+		(isValid ? "passed" : "failed") + ". " + 
+		std::to_string(this->numFailedValidations) + "/" + std::to_string(this->numValidations) + " failed so far. " + 
+		"CPU sort ms: " + std::to_string(cpuSortMs) + 
+		" (" + std::to_string(cpuSortMs > 0.0f ? numSortElements / (cpuSortMs * 1000.0f) : 0.0f) + " M elements/s)"
+	);
+
+	// Keep the first validated keys for the captured distribution of SortBenchmark
+	if (!this->hasCapturedKeys)
+	{
+		this->hasCapturedKeys = true;
+
+		SortBenchmarkKeys capturedKeys;
+		capturedKeys.keys.assign(
+			reinterpret_cast<const uint64_t*>(unsortedData), 
+			reinterpret_cast<const uint64_t*>(unsortedData) + numSortElements
+		);
+		capturedKeys.numSortKeyBits = this->numSortKeyBits;
+		capturedKeys.numTiles = 1u << this->numTileBits;
+		capturedKeys.numCompactTileBits = this->measureQuantization ? 0 : this->numTileBits;
+		SortBenchmark::saveKeys(SortBenchmarkSettings().capturedKeysPath, capturedKeys);
+	}
+
+	if (this->measureQuantization)
+	{
+		Log::write(SortKeyQuantization::toString(
+			SortKeyQuantization::measure(
+				reinterpret_cast<const uint64_t*>(unsortedData), 
+				numSortElements, 
+				this->numTileBits
+			)
+		));
+	}
+}
\ No newline at end of file
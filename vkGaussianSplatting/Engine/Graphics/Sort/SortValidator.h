@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../Buffer/ReadbackBuffer.h"
+
+class StorageBuffer;
+
+// Compares the output of a GpuSort against CpuSort. 
+// Every VALIDATION_INTERVAL frames, the sort list is copied before and after sorting, 
+// and validated once the fence of that frame has been waited on.
+class SortValidator
+{
+private:
+	ReadbackBuffer unsortedReadback;
+	ReadbackBuffer sortedReadback;
+	ReadbackBuffer cullDataReadback;
+
+	uint32_t maxNumSortElements;
+	uint32_t numSortKeyBits;
+	uint32_t numTileBits;
+	bool measureQuantization;
+	bool sortsLivePrefixOnly;
+	bool hasCapturedKeys;
+	uint32_t pendingFrameIndex;
+	uint32_t numFramesUntilValidation;
+	uint32_t numValidations;
+	uint32_t numFailedValidations;
+
+	void recordCopy(
+		CommandBuffer& commandBuffer,
+		const StorageBuffer& srcBuffer,
+		const ReadbackBuffer& dstBuffer,
+		VkDeviceSize size);
+
+public:
+	const static uint32_t VALIDATION_INTERVAL = 60;
+	const static uint32_t NO_PENDING_FRAME = ~0u;
+
+	SortValidator();
+
+	// Compares a sorted list against CpuSort. The lists have the sort list layout, 
+	// where the first numSortElements elements of the unsorted list are used. 
+	// The first numSortedListElements elements of the sorted list are checked, 
+	// where the elements beyond numSortElements have to be unused.
+	static bool validate(
+		const uint64_t* unsortedKeys,
+		const uint32_t* unsortedValues,
+		const uint64_t* sortedKeys,
+		const uint32_t* sortedValues,
+		uint32_t numSortElements,
+		uint32_t numSortedListElements,
+		uint32_t numSortKeyBits,
+		float& cpuSortMs);
+
+	// If measureQuantization is set, the keys are expected to be full 64-bit keys, 
+	// and the reordering caused by compact keys is measured on the same readback. 
+	// If sortsLivePrefixOnly is set, keys beyond the sorted elements are stale and not checked.
+	void create(
+		const GfxAllocContext& gfxAllocContext, 
+		uint32_t maxNumSortElements, 
+		uint32_t numSortKeyBits, 
+		uint32_t numTileBits, 
+		bool measureQuantization,
+		bool sortsLivePrefixOnly);
+	void cleanup();
+
+	// Decides if the sort of this frame should be validated
+	bool beginFrame(uint32_t frameIndex);
+
+	// Recorded after the sort list has been initialized, before sorting
+	void recordUnsortedCopy(CommandBuffer& commandBuffer, const StorageBuffer& sortList);
+
+	// Recorded after sorting
+	void recordSortedCopy(
+		CommandBuffer& commandBuffer, 
+		const StorageBuffer& sortList, 
+		const StorageBuffer& cullData);
+
+	// Validates the copies, if they were recorded for this frame index
+	void validatePendingFrame(uint32_t frameIndex);
+};
\ No newline at end of file
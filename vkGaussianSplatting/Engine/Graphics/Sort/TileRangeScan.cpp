@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "TileRangeScan.h"
+
+TileRangeScan::TileRangeScan()
+	: gfxAllocContext(nullptr),
+	tileRangesSBO(nullptr),
+	numTiles(0),
+	numCompactTileBits(0)
+{
+
+}
+
+void TileRangeScan::singleInitResources(const GfxAllocContext& allocContext)
+{
+	this->gfxAllocContext = &allocContext;
+
+	this->scanPipelineLayout.createPipelineLayout(
+		*this->gfxAllocContext->device,
+		{
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT }
+		},
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		sizeof(TileRangeScanPCD)
+	);
+	this->scanPipeline.createComputePipeline(
+		*this->gfxAllocContext->device,
+		this->scanPipelineLayout,
+		"Resources/Shaders/TileRangeScan.comp.spv"
+	);
+}
+
+void TileRangeScan::setTileRanges(
+	StorageBuffer& tileRangesSBO,
+	uint32_t numTiles,
+	uint32_t numCompactTileBits)
+{
+	this->tileRangesSBO = &tileRangesSBO;
+	this->numTiles = numTiles;
+	this->numCompactTileBits = numCompactTileBits;
+
+	const std::vector<uint32_t> initTileCounts(this->numTiles, 0u);
+	this->tileCountsBuffer.createGpuBuffer(
+		*this->gfxAllocContext,
+		sizeof(initTileCounts[0]) * initTileCounts.size(),
+		initTileCounts.data()
+	);
+}
+
+void TileRangeScan::cleanupForScene()
+{
+	this->tileCountsBuffer.cleanup();
+	this->tileRangesSBO = nullptr;
+}
+
+void TileRangeScan::cleanup()
+{
+	this->cleanupForScene();
+
+	this->scanPipelineLayout.cleanup();
+	this->scanPipeline.cleanup();
+}
+
+void TileRangeScan::gpuClearBuffers(CommandBuffer& commandBuffer)
+{
+	commandBuffer.fillBuffer(
+		this->tileCountsBuffer.getVkBuffer(),
+		this->tileCountsBuffer.getBufferSize(),
+		0u
+	);
+
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		this->tileCountsBuffer.getVkBuffer(),
+		this->tileCountsBuffer.getBufferSize()
+	);
+}
+
+void TileRangeScan::computeRanges(CommandBuffer& commandBuffer)
+{
+	// Wait for the counts, and for the previous frame to have read the ranges
+	std::array<VkBufferMemoryBarrier2, 2> scanMemoryBarriers
+	{
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			this->tileCountsBuffer.getVkBuffer(),
+			this->tileCountsBuffer.getBufferSize()
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			this->tileRangesSBO->getVkBuffer(),
+			this->tileRangesSBO->getBufferSize()
+		)
+	};
+	commandBuffer.bufferMemoryBarrier(
+		scanMemoryBarriers.data(),
+		(uint32_t) scanMemoryBarriers.size()
+	);
+
+	// Compute pipeline
+	commandBuffer.bindPipeline(this->scanPipeline);
+
+	// Binding 0
+	VkDescriptorBufferInfo tileCountsInfo = this->getTileCountsInfo();
+
+	// Binding 1
+	VkDescriptorBufferInfo outputTileRangesInfo{};
+	outputTileRangesInfo.buffer = this->tileRangesSBO->getVkBuffer();
+	outputTileRangesInfo.range = this->tileRangesSBO->getBufferSize();
+
+	// Descriptor sets
+	std::array<VkWriteDescriptorSet, 2> scanDescriptorSets
+	{
+		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &tileCountsInfo),
+		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputTileRangesInfo)
+	};
+	commandBuffer.pushDescriptorSet(
+		this->scanPipelineLayout,
+		0,
+		uint32_t(scanDescriptorSets.size()),
+		scanDescriptorSets.data()
+	);
+
+	// Push constant
+	TileRangeScanPCD scanPcData{};
+	scanPcData.data.x = this->numCompactTileBits;
+	scanPcData.data.y = this->numTiles;
+	commandBuffer.pushConstant(
+		this->scanPipelineLayout,
+		(void*)&scanPcData
+	);
+
+	// Dispatch
+	commandBuffer.dispatch(1);
+}
+
+VkDescriptorBufferInfo TileRangeScan::getTileCountsInfo() const
+{
+	VkDescriptorBufferInfo tileCountsInfo{};
+	tileCountsInfo.buffer = this->tileCountsBuffer.getVkBuffer();
+	tileCountsInfo.range = this->tileCountsBuffer.getBufferSize();
+
+	return tileCountsInfo;
+}
\ No newline at end of file
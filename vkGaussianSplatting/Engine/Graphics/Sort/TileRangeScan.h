@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../Buffer/StorageBuffer.h"
+
+// Tile ranges of a sorted list, from the number of keys within each tile. 
+// Since the tile index is in the highest bits of the keys, the range of a tile 
+// starts at the exclusive prefix sum of the counts. Sorts count the tiles within 
+// a pass already reading every key, which replaces FindRanges and clearing the ranges.
+class TileRangeScan
+{
+private:
+	PipelineLayout scanPipelineLayout;
+	Pipeline scanPipeline;
+
+	StorageBuffer tileCountsBuffer;
+
+	const GfxAllocContext* gfxAllocContext;
+	StorageBuffer* tileRangesSBO;
+
+	uint32_t numTiles;
+	uint32_t numCompactTileBits;
+
+public:
+	TileRangeScan();
+
+	void singleInitResources(const GfxAllocContext& allocContext);
+	void setTileRanges(
+		StorageBuffer& tileRangesSBO,
+		uint32_t numTiles,
+		uint32_t numCompactTileBits);
+	void cleanupForScene();
+	void cleanup();
+
+	void gpuClearBuffers(CommandBuffer& commandBuffer);
+
+	// Records the scan once the counting pass has been recorded
+	void computeRanges(CommandBuffer& commandBuffer);
+
+	// Counts written by the sort, one uint per tile
+	VkDescriptorBufferInfo getTileCountsInfo() const;
+
+	inline uint32_t getNumCompactTileBits() const { return this->numCompactTileBits; }
+	inline bool hasTileRanges() const { return this->tileRangesSBO != nullptr; }
+};
\ No newline at end of file
@@ -38,12 +38,18 @@ void Renderer::computeInitSortList(
 	CommandBuffer& commandBuffer, 
 	const Camera& camera)
 {
-	// Reset gaussian sort keys (make sure close sorted gaussians have lower valued keys)
-	commandBuffer.fillBuffer(
-		this->gaussiansSortListSBO->getVkBuffer(),
-		sizeof(GaussianSortData) * this->numSortElements,
-		std::numeric_limits<uint32_t>::max()
-	);
+	// Reset gaussian sort keys (make sure close sorted gaussians have lower valued keys).
+	// Values are only read for written keys, and don't need to be cleared.
+	// Sorts only touching the first numGaussiansToRender elements never read the rest.
+	const bool clearSortList = !this->gpuSort->sortsLivePrefixOnly();
+	if (clearSortList)
+	{
+		commandBuffer.fillBuffer(
+			this->gaussiansSortListSBO->getVkBuffer(),
+			GaussianSortList::getKeysSize(this->numSortElements),
+			std::numeric_limits<uint32_t>::max()
+		);
+	}
 
 	// Reset gaussian count before culling
 	commandBuffer.fillBuffer(
@@ -51,31 +57,42 @@ void Renderer::computeInitSortList(
 		sizeof(uint32_t),
 		0
 	);
-
-	// Reset ranges
+#ifdef COMPARE_SPLAT_EXTENTS
 	commandBuffer.fillBuffer(
-		this->gaussiansTileRangesSBO.getVkBuffer(),
-		sizeof(GaussianTileRangeData) * this->getNumTiles(),
-		0
+		this->gaussiansCullDataSBO.getVkBuffer(),
+		sizeof(uint32_t),
+		0,
+		2 * sizeof(uint32_t)
 	);
+#endif
 
-	std::array<VkBufferMemoryBarrier2, 4> initBufferBarriers =
+	// Reset ranges (sorts writing the ranges write all of them)
+	if (!this->gpuSort->writesTileRanges())
 	{
-		// Gaussians
+		commandBuffer.fillBuffer(
+			this->gaussiansTileRangesSBO.getVkBuffer(),
+			sizeof(GaussianTileRangeData) * this->getNumTiles(),
+			0
+		);
+	}
+
+	std::array<VkBufferMemoryBarrier2, 5> initBufferBarriers =
+	{
+		// Gaussians splat data
 		PipelineBarrier::bufferMemoryBarrier2(
 			VK_ACCESS_NONE,
-			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
 			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			this->gaussiansSBO.getVkBuffer(),
-			this->gaussiansSBO.getBufferSize()
+			this->gaussiansSplatSBO.getVkBuffer(),
+			this->gaussiansSplatSBO.getBufferSize()
 		),
 
-		// Gaussians sort list
+		// Gaussians sort list (without the clear, InitSortList still waits for the reads of the previous frame)
 		PipelineBarrier::bufferMemoryBarrier2(
-			VK_ACCESS_TRANSFER_WRITE_BIT,
+			clearSortList ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_NONE,
 			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			clearSortList ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
 			this->gaussiansSortListSBO->getVkBuffer(),
 			this->gaussiansSortListSBO->getBufferSize()
@@ -100,6 +117,16 @@ void Renderer::computeInitSortList(
 			this->gaussiansTileRangesSBO.getVkBuffer(),
 			this->gaussiansTileRangesSBO.getBufferSize()
 		),
+
+		// Gaussian element counts (read by the two-phase passes of the previous frame)
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			this->initSortListCountsSBO.getVkBuffer(),
+			this->initSortListCountsSBO.getBufferSize()
+		),
 	};
 	commandBuffer.bufferMemoryBarrier(
 		initBufferBarriers.data(),
@@ -110,7 +137,7 @@ void Renderer::computeInitSortList(
 	this->gpuSort->gpuClearBuffers(commandBuffer);
 
 	// Compute pipeline
-	commandBuffer.bindPipeline(this->initSortListPipeline);
+	commandBuffer.bindPipeline(this->initSortListPipelines[this->sceneShDegree]);
 
 	// Binding 0
 	VkDescriptorBufferInfo inputCamUboInfo{};
@@ -118,28 +145,56 @@ void Renderer::computeInitSortList(
 	inputCamUboInfo.range = this->camUBO.getBufferSize();
 
 	// Binding 1
-	VkDescriptorBufferInfo inputGaussiansBufferInfo{};
-	inputGaussiansBufferInfo.buffer = this->gaussiansSBO.getVkBuffer();
-	inputGaussiansBufferInfo.range = this->gaussiansSBO.getBufferSize();
+	VkDescriptorBufferInfo inputGaussiansGeometryInfo{};
+	inputGaussiansGeometryInfo.buffer = this->gaussiansGeometrySBO.getVkBuffer();
+	inputGaussiansGeometryInfo.range = this->gaussiansGeometrySBO.getBufferSize();
 
 	// Binding 2
-	VkDescriptorBufferInfo outputGaussiansSortInfo{};
-	outputGaussiansSortInfo.buffer = this->gaussiansSortListSBO->getVkBuffer();
-	outputGaussiansSortInfo.range = this->gaussiansSortListSBO->getBufferSize();
+	VkDescriptorBufferInfo inputGaussiansShInfo{};
+	inputGaussiansShInfo.buffer = this->gaussiansShSBO.getVkBuffer();
+	inputGaussiansShInfo.range = this->gaussiansShSBO.getBufferSize();
 
 	// Binding 3
+	VkDescriptorBufferInfo outputGaussiansSplatInfo{};
+	outputGaussiansSplatInfo.buffer = this->gaussiansSplatSBO.getVkBuffer();
+	outputGaussiansSplatInfo.range = this->gaussiansSplatSBO.getBufferSize();
+
+	// Binding 4
+	VkDescriptorBufferInfo outputGaussiansSortKeysInfo = 
+		GpuSort::getSortKeysInfo(*this->gaussiansSortListSBO, this->numSortElements);
+
+	// Binding 5
+	VkDescriptorBufferInfo outputGaussiansSortValuesInfo = 
+		GpuSort::getSortValuesInfo(*this->gaussiansSortListSBO, this->numSortElements);
+
+	// Binding 6
 	VkDescriptorBufferInfo outputGaussiansCullInfo{};
 	outputGaussiansCullInfo.buffer = this->gaussiansCullDataSBO.getVkBuffer();
 	outputGaussiansCullInfo.range = this->gaussiansCullDataSBO.getBufferSize();
 
+	// Binding 7
+	VkDescriptorBufferInfo outputTileRectsInfo{};
+	outputTileRectsInfo.buffer = this->initSortListTileRectsSBO.getVkBuffer();
+	outputTileRectsInfo.range = this->initSortListTileRectsSBO.getBufferSize();
+
+	// Binding 8
+	VkDescriptorBufferInfo outputElementCountsInfo{};
+	outputElementCountsInfo.buffer = this->initSortListCountsSBO.getVkBuffer();
+	outputElementCountsInfo.range = this->initSortListCountsSBO.getBufferSize();
+
 	// Descriptor sets
-	std::array<VkWriteDescriptorSet, 4> computeWriteDescriptorSets
+	std::array<VkWriteDescriptorSet, 9> computeWriteDescriptorSets
 	{
 		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &inputCamUboInfo),
-		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansBufferInfo),
-
-		DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSortInfo),
-		DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansCullInfo)
+		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansGeometryInfo),
+		DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansShInfo),
+
+		DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSplatInfo),
+		DescriptorSet::writeBuffer(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSortKeysInfo),
+		DescriptorSet::writeBuffer(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSortValuesInfo),
+		DescriptorSet::writeBuffer(6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansCullInfo),
+		DescriptorSet::writeBuffer(7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputTileRectsInfo),
+		DescriptorSet::writeBuffer(8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputElementCountsInfo)
 	};
 	commandBuffer.pushDescriptorSet(
 		this->initSortListPipelineLayout,
@@ -149,13 +204,19 @@ void Renderer::computeInitSortList(
 	);
 
 	// Push constant
+	const bool twoPhase = this->usesTwoPhaseInitSortList();
 	InitSortListPCD initSortListPcData{};
-	initSortListPcData.clipPlanes = glm::vec4(camera.NEAR_PLANE, camera.FAR_PLANE, (float) this->numGaussians, 0.0f);
+	initSortListPcData.clipPlanes = glm::vec4(
+		camera.NEAR_PLANE, 
+		camera.FAR_PLANE, 
+		(float) this->numGaussians, 
+		twoPhase ? 1.0f : 0.0f
+	);
 	initSortListPcData.camPos = glm::vec4(camera.getPosition(), (float) camera.getShMode());
 	initSortListPcData.resolution = glm::uvec4(
 		this->swapchain.getVkExtent().width,
 		this->swapchain.getVkExtent().height, 
-		0, 
+		this->getNumCompactTileBits(), 
 		0
 	);
 	commandBuffer.pushConstant(
@@ -167,31 +228,298 @@ void Renderer::computeInitSortList(
 	commandBuffer.dispatch(
 		(this->numGaussians + INIT_LIST_WORK_GROUP_SIZE - 1) / INIT_LIST_WORK_GROUP_SIZE
 	);
+
+	// The two-phase InitSortList has only written the tile rects and element counts so far
+	if (twoPhase)
+	{
+		this->computeInitSortListElements(
+			commandBuffer, 
+			outputTileRectsInfo
+		);
+	}
+}
+
+void Renderer::computeInitSortListElements(
+	CommandBuffer& commandBuffer, 
+	const VkDescriptorBufferInfo& tileRectsInfo)
+{
+	const uint32_t numBlocks = this->getNumInitListScanBlocks(this->numGaussians);
+
+	// Push constant, shared by all passes
+	InitSortListScanPCD scanPcData{};
+	scanPcData.data = glm::uvec4(
+		this->numGaussians, 
+		numBlocks, 
+		this->getTileGridSize().x, 
+		this->getNumCompactTileBits()
+	);
+
+	VkDescriptorBufferInfo gaussiansSplatInfo{};
+	gaussiansSplatInfo.buffer = this->gaussiansSplatSBO.getVkBuffer();
+	gaussiansSplatInfo.range = this->gaussiansSplatSBO.getBufferSize();
+	VkDescriptorBufferInfo elementCountsInfo{};
+	elementCountsInfo.buffer = this->initSortListCountsSBO.getVkBuffer();
+	elementCountsInfo.range = this->initSortListCountsSBO.getBufferSize();
+	VkDescriptorBufferInfo blockSumsInfo{};
+	blockSumsInfo.buffer = this->initSortListBlockSumsSBO.getVkBuffer();
+	blockSumsInfo.range = this->initSortListBlockSumsSBO.getBufferSize();
+
+	// Wait for the tile rects, splats and element counts, and for the previous frame to have 
+	// read the block offsets
+	std::array<VkBufferMemoryBarrier2, 4> reduceMemoryBarriers
+	{
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			tileRectsInfo.buffer,
+			tileRectsInfo.range
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			gaussiansSplatInfo.buffer,
+			gaussiansSplatInfo.range
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			elementCountsInfo.buffer,
+			elementCountsInfo.range
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			blockSumsInfo.buffer,
+			blockSumsInfo.range
+		)
+	};
+	commandBuffer.bufferMemoryBarrier(
+		reduceMemoryBarriers.data(),
+		(uint32_t) reduceMemoryBarriers.size()
+	);
+
+	// ------------------ 1. Reduce (element count per block of gaussians) ------------------
+	{
+		commandBuffer.bindPipeline(this->initSortListReducePipeline);
+
+		std::array<VkWriteDescriptorSet, 2> reduceDescriptorSets
+		{
+			DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &elementCountsInfo),
+			DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &blockSumsInfo)
+		};
+		commandBuffer.pushDescriptorSet(
+			this->initSortListReducePipelineLayout,
+			0,
+			uint32_t(reduceDescriptorSets.size()),
+			reduceDescriptorSets.data()
+		);
+		commandBuffer.pushConstant(
+			this->initSortListReducePipelineLayout,
+			(void*)&scanPcData
+		);
+
+		commandBuffer.dispatch(numBlocks);
+	}
+
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		blockSumsInfo.buffer,
+		blockSumsInfo.range
+	);
+
+	// ------------------ 2. Scan (offset per block, and the total element count) ------------------
+	VkDescriptorBufferInfo cullDataInfo{};
+	cullDataInfo.buffer = this->gaussiansCullDataSBO.getVkBuffer();
+	cullDataInfo.range = this->gaussiansCullDataSBO.getBufferSize();
+	{
+		commandBuffer.bindPipeline(this->initSortListScanPipeline);
+
+		std::array<VkWriteDescriptorSet, 2> scanDescriptorSets
+		{
+			DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &blockSumsInfo),
+			DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &cullDataInfo)
+		};
+		commandBuffer.pushDescriptorSet(
+			this->initSortListScanPipelineLayout,
+			0,
+			uint32_t(scanDescriptorSets.size()),
+			scanDescriptorSets.data()
+		);
+		commandBuffer.pushConstant(
+			this->initSortListScanPipelineLayout,
+			(void*)&scanPcData
+		);
+
+		commandBuffer.dispatch(1);
+	}
+
+	std::array<VkBufferMemoryBarrier2, 2> scanMemoryBarriers
+	{
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			blockSumsInfo.buffer,
+			blockSumsInfo.range
+		),
+
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			cullDataInfo.buffer,
+			cullDataInfo.range
+		)
+	};
+	commandBuffer.bufferMemoryBarrier(
+		scanMemoryBarriers.data(),
+		(uint32_t) scanMemoryBarriers.size()
+	);
+
+	// ------------------ 3. Write (elements at the scanned offsets) ------------------
+	{
+		commandBuffer.bindPipeline(this->initSortListWritePipeline);
+
+		VkDescriptorBufferInfo outputGaussiansSortKeysInfo = 
+			GpuSort::getSortKeysInfo(*this->gaussiansSortListSBO, this->numSortElements);
+		VkDescriptorBufferInfo outputGaussiansSortValuesInfo = 
+			GpuSort::getSortValuesInfo(*this->gaussiansSortListSBO, this->numSortElements);
+
+		std::array<VkWriteDescriptorSet, 7> writeDescriptorSets
+		{
+			DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &tileRectsInfo),
+			DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &gaussiansSplatInfo),
+			DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &elementCountsInfo),
+			DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &blockSumsInfo),
+			DescriptorSet::writeBuffer(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSortKeysInfo),
+			DescriptorSet::writeBuffer(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansSortValuesInfo),
+			DescriptorSet::writeBuffer(6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &cullDataInfo)
+		};
+		commandBuffer.pushDescriptorSet(
+			this->initSortListWritePipelineLayout,
+			0,
+			uint32_t(writeDescriptorSets.size()),
+			writeDescriptorSets.data()
+		);
+		commandBuffer.pushConstant(
+			this->initSortListWritePipelineLayout,
+			(void*)&scanPcData
+		);
+
+		commandBuffer.dispatch(numBlocks);
+	}
 }
 
 void Renderer::computeRanges(CommandBuffer& commandBuffer)
 {
-	// *Memory barrier has already been inserted at the end of the last sorting pass*
+	// *Memory barrier on the sort list has already been inserted at the end of the last sorting pass*
+
+	// Cull data from InitSortList, and the previous frame's dispatch parameters
+	std::array<VkBufferMemoryBarrier2, 2> indirectSetupBarriers =
+	{
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			this->gaussiansCullDataSBO.getVkBuffer(),
+			this->gaussiansCullDataSBO.getBufferSize()
+		),
+		PipelineBarrier::bufferMemoryBarrier2(
+			VK_ACCESS_NONE,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			this->findRangesIndirectDispatchSBO.getVkBuffer(),
+			this->findRangesIndirectDispatchSBO.getBufferSize()
+		)
+	};
+	commandBuffer.bufferMemoryBarrier(
+		indirectSetupBarriers.data(),
+		(uint32_t) indirectSetupBarriers.size()
+	);
+
+	// Indirect setup, dispatching FindRanges only over the elements InitSortList wrote
+	{
+		commandBuffer.bindPipeline(this->findRangesIndirectSetupPipeline);
+
+		// Binding 0
+		VkDescriptorBufferInfo inputCullInfo{};
+		inputCullInfo.buffer = this->gaussiansCullDataSBO.getVkBuffer();
+		inputCullInfo.range = this->gaussiansCullDataSBO.getBufferSize();
+
+		// Binding 1
+		VkDescriptorBufferInfo outputIndirectDispatchInfo{};
+		outputIndirectDispatchInfo.buffer = this->findRangesIndirectDispatchSBO.getVkBuffer();
+		outputIndirectDispatchInfo.range = this->findRangesIndirectDispatchSBO.getBufferSize();
+
+		// Descriptor sets
+		std::array<VkWriteDescriptorSet, 2> indirectSetupDescriptorSets
+		{
+			DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputCullInfo),
+			DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputIndirectDispatchInfo),
+		};
+		commandBuffer.pushDescriptorSet(
+			this->findRangesIndirectSetupPipelineLayout,
+			0,
+			uint32_t(indirectSetupDescriptorSets.size()),
+			indirectSetupDescriptorSets.data()
+		);
+
+		commandBuffer.dispatch(1);
+	}
+
+	// Wait on dispatch parameters
+	commandBuffer.bufferMemoryBarrier(
+		VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+		this->findRangesIndirectDispatchSBO.getVkBuffer(),
+		this->findRangesIndirectDispatchSBO.getBufferSize()
+	);
 
 	// Compute pipeline
 	commandBuffer.bindPipeline(this->findRangesPipeline);
 
 	// Binding 0
-	VkDescriptorBufferInfo inputGaussiansSortInfo{};
-	inputGaussiansSortInfo.buffer = this->gaussiansSortListSBO->getVkBuffer();
-	inputGaussiansSortInfo.range = this->gaussiansSortListSBO->getBufferSize();
+	VkDescriptorBufferInfo inputGaussiansSortKeysInfo = 
+		GpuSort::getSortKeysInfo(*this->gaussiansSortListSBO, this->numSortElements);
 
 	// Binding 1
 	VkDescriptorBufferInfo outputGaussiansRangeInfo{};
 	outputGaussiansRangeInfo.buffer = this->gaussiansTileRangesSBO.getVkBuffer();
 	outputGaussiansRangeInfo.range = this->gaussiansTileRangesSBO.getBufferSize();
 
+	// Binding 2
+	VkDescriptorBufferInfo inputIndirectDispatchInfo{};
+	inputIndirectDispatchInfo.buffer = this->findRangesIndirectDispatchSBO.getVkBuffer();
+	inputIndirectDispatchInfo.range = this->findRangesIndirectDispatchSBO.getBufferSize();
+
 	// Descriptor sets
-	std::array<VkWriteDescriptorSet, 2> computeWriteDescriptorSets
+	std::array<VkWriteDescriptorSet, 3> computeWriteDescriptorSets
 	{
-		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortInfo),
+		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortKeysInfo),
 
 		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &outputGaussiansRangeInfo),
+
+		DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputIndirectDispatchInfo),
 	};
 	commandBuffer.pushDescriptorSet(
 		this->findRangesPipelineLayout,
@@ -202,16 +530,16 @@ void Renderer::computeRanges(CommandBuffer& commandBuffer)
 
 	// Push constant
 	FindRangesPCD findRangesPcData{};
-	findRangesPcData.data.x = this->numSortElements;
+	findRangesPcData.data.x = this->getNumCompactTileBits();
 	commandBuffer.pushConstant(
 		this->findRangesPipelineLayout,
 		(void*)&findRangesPcData
 	);
 
 	// Run compute shader
-	// TODO: make this an indirect dispatch if radix sort is being used
-	commandBuffer.dispatch(
-		(this->numSortElements + FIND_RANGES_GROUP_SIZE - 1) / FIND_RANGES_GROUP_SIZE
+	commandBuffer.dispatchIndirect(
+		this->findRangesIndirectDispatchSBO.getVkBuffer(),
+		offsetof(FindRangesIndirectDispatch, sizeX)
 	);
 }
 
@@ -250,14 +578,14 @@ void Renderer::computeRenderGaussians(
 			this->gaussiansTileRangesSBO.getBufferSize()
 		),
 
-		// Gaussians
+		// Gaussians splat data
 		PipelineBarrier::bufferMemoryBarrier2(
-			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
 			VK_ACCESS_SHADER_READ_BIT,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			this->gaussiansSBO.getVkBuffer(),
-			this->gaussiansSBO.getBufferSize()
+			this->gaussiansSplatSBO.getVkBuffer(),
+			this->gaussiansSplatSBO.getBufferSize()
 		)
 	};
 
@@ -270,14 +598,13 @@ void Renderer::computeRenderGaussians(
 	commandBuffer.bindPipeline(this->renderGaussiansPipeline);
 
 	// Binding 0
-	VkDescriptorBufferInfo inputGaussiansInfo{};
-	inputGaussiansInfo.buffer = this->gaussiansSBO.getVkBuffer();
-	inputGaussiansInfo.range = this->gaussiansSBO.getBufferSize();
+	VkDescriptorBufferInfo inputGaussiansSplatInfo{};
+	inputGaussiansSplatInfo.buffer = this->gaussiansSplatSBO.getVkBuffer();
+	inputGaussiansSplatInfo.range = this->gaussiansSplatSBO.getBufferSize();
 
 	// Binding 1
-	VkDescriptorBufferInfo inputGaussiansSortListInfo{};
-	inputGaussiansSortListInfo.buffer = this->gaussiansSortListSBO->getVkBuffer();
-	inputGaussiansSortListInfo.range = this->gaussiansSortListSBO->getBufferSize();
+	VkDescriptorBufferInfo inputGaussiansSortValuesInfo = 
+		GpuSort::getSortValuesInfo(*this->gaussiansSortListSBO, this->numSortElements);
 
 	// Binding 2
 	VkDescriptorBufferInfo inputGaussiansRangeInfo{};
@@ -285,25 +612,18 @@ void Renderer::computeRenderGaussians(
 	inputGaussiansRangeInfo.range = this->gaussiansTileRangesSBO.getBufferSize();
 
 	// Binding 3
-	VkDescriptorBufferInfo inputCamUboInfo{};
-	inputCamUboInfo.buffer = this->camUBO.getVkBuffer(GfxState::currentFrameIndex);
-	inputCamUboInfo.range = this->camUBO.getBufferSize();
-
-	// Binding 4
 	VkDescriptorImageInfo outputImageInfo{};
 	outputImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 	outputImageInfo.imageView = this->swapchain.getVkImageView(imageIndex);
 
 	// Descriptor set
-	std::array<VkWriteDescriptorSet, 5> computeWriteDescriptorSets
+	std::array<VkWriteDescriptorSet, 4> computeWriteDescriptorSets
 	{
-		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansInfo),
-		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortListInfo),
+		DescriptorSet::writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSplatInfo),
+		DescriptorSet::writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansSortValuesInfo),
 		DescriptorSet::writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &inputGaussiansRangeInfo),
 
-		DescriptorSet::writeBuffer(3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &inputCamUboInfo),
-
-		DescriptorSet::writeImage(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &outputImageInfo)
+		DescriptorSet::writeImage(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &outputImageInfo)
 	};
 	commandBuffer.pushDescriptorSet(
 		this->renderGaussiansPipelineLayout,
@@ -142,9 +142,23 @@ void CommandBuffer::pushConstant(
 	);
 }
 
-void CommandBuffer::fillBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t data)
+void CommandBuffer::fillBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t data, VkDeviceSize offset)
 {
-	vkCmdFillBuffer(this->commandBuffer, buffer, 0, size, data);
+	vkCmdFillBuffer(this->commandBuffer, buffer, offset, size, data);
+}
+
+void CommandBuffer::copyBuffer(
+	VkBuffer srcBuffer, 
+	VkBuffer dstBuffer, 
+	VkDeviceSize size, 
+	VkDeviceSize srcOffset, 
+	VkDeviceSize dstOffset)
+{
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = srcOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(this->commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 }
 
 void CommandBuffer::drawIndexed(uint32_t numIndices, uint32_t firstIndex)
@@ -329,8 +343,11 @@ void CommandBuffer::endSingleTimeUse(const GfxAllocContext& gfxAllocContext)
 	VkSubmitInfo submitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &this->commandBuffer;
-	vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-	vkQueueWaitIdle(queue);
+	{
+		std::lock_guard<std::mutex> queueLock(gfxAllocContext.queueFamilies->getQueueMutex());
+		vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+		vkQueueWaitIdle(queue);
+	}
 
 	// Deallocate temporary command buffer
 	vkFreeCommandBuffers(
@@ -42,7 +42,13 @@ public:
 	void pushConstant(
 		const PipelineLayout& pipelineLayout,
 		const void* data);
-	void fillBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t data);
+	void fillBuffer(VkBuffer buffer, VkDeviceSize size, uint32_t data, VkDeviceSize offset = 0);
+	void copyBuffer(
+		VkBuffer srcBuffer, 
+		VkBuffer dstBuffer, 
+		VkDeviceSize size, 
+		VkDeviceSize srcOffset = 0, 
+		VkDeviceSize dstOffset = 0);
 	void drawIndexed(uint32_t numIndices, uint32_t firstIndex);
 	void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
 	void dispatchIndirect(VkBuffer buffer, VkDeviceSize offset);
@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include <mutex>
 #include <optional>
 
 struct QueueFamilyIndices
@@ -24,6 +25,9 @@ private:
 
 	QueueFamilyIndices indices;
 
+	// Queues are shared between the render loop and background scene loading
+	std::mutex queueMutex;
+
 public:
 	QueueFamilies();
 	~QueueFamilies();
@@ -39,4 +43,5 @@ public:
 	inline VkQueue& getVkGraphicsQueue() { return this->graphicsQueue; }
 	inline VkQueue& getVkPresentQueue() { return this->presentQueue; }
 	inline const QueueFamilyIndices& getIndices() const { return this->indices; }
+	inline std::mutex& getQueueMutex() { return this->queueMutex; }
 };
\ No newline at end of file
@@ -4,10 +4,18 @@
 #include "Graphics/MeshData.h"
 #include "Graphics/Texture/TextureCube.h"
 #include "Graphics/Texture/Texture2D.h"
+#include "Graphics/Buffer/StagingRing.h"
+#include "Dev/ParallelFor.h"
+#include "Dev/ParallelRadixSort.h"
 #include "../Dev/StrHelper.h"
 
 ResourceManager::ResourceManager()
-	: gfxAllocContext(nullptr)
+	: gfxAllocContext(nullptr),
+	gaussianOrdering(GaussianOrdering::MORTON_32),
+	useGaussianCache(true),
+	useProgressiveLoading(false),
+	shStorageMode(ShStorageMode::FLOAT32),
+	gaussianShDegree(GaussianShData::MAX_DEGREE)
 {
 }
 
@@ -40,8 +48,14 @@ void ResourceManager::cleanup()
 
 void ResourceManager::clearAllGaussians()
 {
+	this->gaussianCache.close();
+	this->gaussianPlyReader.close();
+	this->gaussianPlyOrder.clear();
+	this->gaussianPlyOrder.shrink_to_fit();
+	this->gaussianFilePath.clear();
 	this->gaussians.clear();
 	this->gaussians.shrink_to_fit();
+	this->gaussianShDegree = GaussianShData::MAX_DEGREE;
 }
 
 uint32_t ResourceManager::addMesh(
@@ -157,6 +171,11 @@ uint32_t ResourceManager::addCubeMap(const std::vector<std::string>& filePaths)
 
 uint32_t ResourceManager::addGaussian(const GaussianData& gaussianData)
 {
+	this->copyGaussiansToVector();
+
+	// Manually added gaussians can use every coefficient
+	this->gaussianShDegree = GaussianShData::MAX_DEGREE;
+
 	uint32_t gaussianId = (uint32_t) this->gaussians.size();
 
 	this->gaussians.push_back(gaussianData);
@@ -164,6 +183,499 @@ uint32_t ResourceManager::addGaussian(const GaussianData& gaussianData)
 	return gaussianId;
 }
 
+bool ResourceManager::getGaussianPlyOffsets(
+	const PlyReader& plyReader, 
+	const std::string& filePath,
+	GaussianPlyOffsets& output) const
+{
+	// The number of higher band coefficients determines the degree
+	uint32_t numRestFloats = 0;
+	while (plyReader.hasProperty("f_rest_" + std::to_string(numRestFloats)))
+		numRestFloats++;
+	output.shDegree = GaussianShData::MAX_DEGREE + 1;
+	for (uint32_t degree = 0; degree <= GaussianShData::MAX_DEGREE; ++degree)
+	{
+		if ((GaussianShData::getNumCoeffs(degree) - 1) * 3 == numRestFloats)
+			output.shDegree = degree;
+	}
+	if (output.shDegree > GaussianShData::MAX_DEGREE)
+	{
+		Log::error("Unsupported number of spherical harmonics coefficients (" + std::to_string(numRestFloats) + " \"f_rest_*\" properties) in .ply file: " + filePath);
+		return false;
+	}
+	output.numShRestCoeffs = numRestFloats / 3;
+	const uint32_t numRestCoeffs = output.numShRestCoeffs;
+
+	std::vector<std::pair<std::string, uint32_t*>> properties =
+	{
+		{ "x", &output.position[0] },
+		{ "y", &output.position[1] },
+		{ "z", &output.position[2] },
+
+		{ "scale_0", &output.scale[0] },
+		{ "scale_1", &output.scale[1] },
+		{ "scale_2", &output.scale[2] },
+
+		{ "rot_0", &output.rot[0] },
+		{ "rot_1", &output.rot[1] },
+		{ "rot_2", &output.rot[2] },
+		{ "rot_3", &output.rot[3] },
+
+		{ "opacity", &output.opacity },
+
+		{ "f_dc_0", &output.shDc[0] },
+		{ "f_dc_1", &output.shDc[1] },
+		{ "f_dc_2", &output.shDc[2] }
+	};
+	for (uint32_t i = 0; i < numRestCoeffs * 3; ++i)
+		properties.push_back({ "f_rest_" + std::to_string(i), &output.shRest[i] });
+
+	for (size_t i = 0; i < properties.size(); ++i)
+	{
+		if (!plyReader.getFloatPropertyOffset(properties[i].first, *properties[i].second))
+		{
+			Log::error("Float property \"" + properties[i].first + "\" could not be found in .ply file: " + filePath);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+glm::vec3 ResourceManager::decodeGaussianPosition(
+	const uint8_t* vertexRecord,
+	const GaussianPlyOffsets& offsets)
+{
+	return glm::vec3(
+		PlyReader::readFloat(vertexRecord, offsets.position[0]) * -1.0f,
+		PlyReader::readFloat(vertexRecord, offsets.position[1]) * -1.0f,
+		PlyReader::readFloat(vertexRecord, offsets.position[2])
+	);
+}
+
+void ResourceManager::decodeGaussian(
+	const uint8_t* vertexRecord,
+	const GaussianPlyOffsets& offsets,
+	GaussianData& output)
+{
+	const uint32_t numRestCoeffs = offsets.numShRestCoeffs;
+
+	output.position = glm::vec4(ResourceManager::decodeGaussianPosition(vertexRecord, offsets), 0.0f);
+
+	// Scale and opacity activations share one vectorized exp
+	const glm::vec4 expScaleOpacity = SMath::exp4(
+		glm::vec4(
+			PlyReader::readFloat(vertexRecord, offsets.scale[0]),
+			PlyReader::readFloat(vertexRecord, offsets.scale[1]),
+			PlyReader::readFloat(vertexRecord, offsets.scale[2]),
+			-PlyReader::readFloat(vertexRecord, offsets.opacity)
+		)
+	);
+	output.scale = glm::vec4(glm::vec3(expScaleOpacity), 0.0f);
+	{
+		output.rot = glm::vec4(
+			PlyReader::readFloat(vertexRecord, offsets.rot[0]),
+			PlyReader::readFloat(vertexRecord, offsets.rot[1]),
+			PlyReader::readFloat(vertexRecord, offsets.rot[2]),
+			PlyReader::readFloat(vertexRecord, offsets.rot[3])
+		);
+		output.rot = glm::normalize(output.rot);
+		output.rot = glm::vec4(
+			-output.rot[2],
+			-output.rot[3],
+			output.rot[0],
+			-output.rot[1]
+		);
+	}
+
+	output.shCoeffs[0] = glm::vec4(
+		PlyReader::readFloat(vertexRecord, offsets.shDc[0]),
+		PlyReader::readFloat(vertexRecord, offsets.shDc[1]),
+		PlyReader::readFloat(vertexRecord, offsets.shDc[2]),
+		(1.0f / (1.0f + expScaleOpacity.w))
+	);
+	for (uint32_t c = 0; c < numRestCoeffs; ++c)
+	{
+		output.shCoeffs[c + 1] = glm::vec4(
+			PlyReader::readFloat(vertexRecord, offsets.shRest[c + numRestCoeffs * 0]),
+			PlyReader::readFloat(vertexRecord, offsets.shRest[c + numRestCoeffs * 1]),
+			PlyReader::readFloat(vertexRecord, offsets.shRest[c + numRestCoeffs * 2]),
+			0.0f
+		);
+	}
+	for (uint32_t c = numRestCoeffs; c < GaussianPlyOffsets::MAX_SH_REST_COEFFS; ++c)
+		output.shCoeffs[c + 1] = glm::vec4(0.0f);
+}
+
+void ResourceManager::splitGaussian(
+	const GaussianData& gaussian,
+	GaussianGeometryData& outputGeometry,
+	GaussianShData& outputSh)
+{
+	// Opacity is stored in the unused lane of the position
+	outputGeometry.position = glm::vec4(glm::vec3(gaussian.position), gaussian.shCoeffs[0].a);
+	outputGeometry.scale = gaussian.scale;
+	outputGeometry.rot = gaussian.rot;
+
+	for (uint32_t c = 0; c < GaussianShData::NUM_COEFFS; ++c)
+	{
+		outputSh.coeffs[c * 3 + 0] = gaussian.shCoeffs[c].x;
+		outputSh.coeffs[c * 3 + 1] = gaussian.shCoeffs[c].y;
+		outputSh.coeffs[c * 3 + 2] = gaussian.shCoeffs[c].z;
+	}
+}
+
+float ResourceManager::getGaussianImportance(const glm::vec3& scale, float opacity)
+{
+	// Opacity times the largest cross section of the ellipsoid, which roughly 
+	// corresponds to how much of the screen the gaussian covers when seen from its widest side
+	const float crossSection = std::max(
+		std::max(scale.x * scale.y, scale.y * scale.z), 
+		scale.x * scale.z
+	);
+	const float importance = opacity * crossSection;
+
+	return importance > 0.0f ? importance : 0.0f;
+}
+
+float ResourceManager::decodeGaussianImportance(
+	const uint8_t* vertexRecord,
+	const GaussianPlyOffsets& offsets)
+{
+	// Same activations as in decodeGaussian()
+	const glm::vec4 expScaleOpacity = SMath::exp4(
+		glm::vec4(
+			PlyReader::readFloat(vertexRecord, offsets.scale[0]),
+			PlyReader::readFloat(vertexRecord, offsets.scale[1]),
+			PlyReader::readFloat(vertexRecord, offsets.scale[2]),
+			-PlyReader::readFloat(vertexRecord, offsets.opacity)
+		)
+	);
+
+	return ResourceManager::getGaussianImportance(
+		glm::vec3(expScaleOpacity), 
+		1.0f / (1.0f + expScaleOpacity.w)
+	);
+}
+
+template <typename ImportanceFunc>
+void ResourceManager::applyImportanceBatches(
+	size_t numGaussians, 
+	const ImportanceFunc& importanceFunc, 
+	std::vector<uint32_t>& order)
+{
+	const uint32_t numThreads = ParallelFor::getNumThreads(numGaussians, 16384);
+
+	// Rank gaussians by decreasing importance. Importance is never negative, 
+	// so the inverted float bits sort in the same order as unsigned integers.
+	std::vector<uint32_t> keys(numGaussians);
+	std::vector<uint32_t> importanceOrder(numGaussians);
+	ParallelFor::run(
+		numGaussians,
+		numThreads,
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t i = beginIndex; i < endIndex; ++i)
+			{
+				const float importance = importanceFunc(i);
+				uint32_t importanceBits;
+				std::memcpy(&importanceBits, &importance, sizeof(importanceBits));
+
+				keys[i] = ~importanceBits;
+				importanceOrder[i] = (uint32_t) i;
+			}
+		}
+	);
+	ParallelRadixSort<uint32_t>::sort(keys, importanceOrder);
+
+	// Batch index of each gaussian, from its rank
+	std::vector<uint32_t> gaussianBatches(numGaussians);
+	ParallelFor::run(
+		numGaussians,
+		numThreads,
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t rank = beginIndex; rank < endIndex; ++rank)
+			{
+				uint32_t batch = 0;
+				while (((PROGRESSIVE_FIRST_BATCH_SIZE << (batch + 1)) - PROGRESSIVE_FIRST_BATCH_SIZE) <= rank)
+					batch++;
+
+				gaussianBatches[importanceOrder[rank]] = batch;
+			}
+		}
+	);
+
+	// Group the given order by batch. The sort is stable, so the 
+	// existing (spatial) order is kept within each batch.
+	ParallelFor::run(
+		numGaussians,
+		numThreads,
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t i = beginIndex; i < endIndex; ++i)
+				keys[i] = gaussianBatches[order[i]];
+		}
+	);
+	ParallelRadixSort<uint32_t>::sort(keys, order, 8);
+}
+
+template <typename KeyType, typename PositionFunc, typename EncodeFunc>
+void ResourceManager::computeCurveOrderByKey(
+	size_t numGaussians, 
+	const PositionFunc& positionFunc, 
+	const glm::vec3& minPos, 
+	const glm::vec3& maxPos, 
+	uint32_t numThreads, 
+	uint32_t numBitsPerAxis, 
+	const EncodeFunc& encodeFunc, 
+	std::vector<uint32_t>& outputOrder)
+{
+	const glm::vec3 deltaMinMax = glm::max(maxPos - minPos, glm::vec3(1e-7f));
+	const uint32_t curveSpaceSize = (1u << numBitsPerAxis) - 1;
+
+	// Compute each key once
+	std::vector<KeyType> sortKeys(numGaussians);
+	outputOrder.resize(numGaussians);
+	ParallelFor::run(
+		numGaussians,
+		numThreads,
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t i = beginIndex; i < endIndex; ++i)
+			{
+				const glm::vec3 curveSpacePos = glm::clamp(
+					(positionFunc(i) - minPos) / deltaMinMax, 
+					glm::vec3(0.0f), 
+					glm::vec3(1.0f)
+				) * (float) curveSpaceSize;
+
+				sortKeys[i] = encodeFunc(glm::uvec3(curveSpacePos));
+				outputOrder[i] = (uint32_t) i;
+			}
+		}
+	);
+
+	// Sort the index permutation by key
+	ParallelRadixSort<KeyType>::sort(sortKeys, outputOrder, numBitsPerAxis * 3);
+}
+
+template <typename PositionFunc>
+void ResourceManager::computeCurveOrder(
+	GaussianOrdering ordering, 
+	size_t numGaussians, 
+	const PositionFunc& positionFunc, 
+	std::vector<uint32_t>& outputOrder)
+{
+	const uint32_t numThreads = ParallelFor::getNumThreads(numGaussians, 16384);
+
+	// Bounds, reduced per thread and then merged
+	std::vector<glm::vec3> threadMinPos(numThreads, glm::vec3(std::numeric_limits<float>::max()));
+	std::vector<glm::vec3> threadMaxPos(numThreads, glm::vec3(std::numeric_limits<float>::lowest()));
+	ParallelFor::run(
+		numGaussians,
+		numThreads,
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			glm::vec3 localMinPos = threadMinPos[threadIndex];
+			glm::vec3 localMaxPos = threadMaxPos[threadIndex];
+			for (size_t i = beginIndex; i < endIndex; ++i)
+			{
+				const glm::vec3 position = positionFunc(i);
+				localMinPos = glm::min(localMinPos, position);
+				localMaxPos = glm::max(localMaxPos, position);
+			}
+			threadMinPos[threadIndex] = localMinPos;
+			threadMaxPos[threadIndex] = localMaxPos;
+		}
+	);
+	glm::vec3 minPos = threadMinPos[0];
+	glm::vec3 maxPos = threadMaxPos[0];
+	for (uint32_t i = 1; i < numThreads; ++i)
+	{
+		minPos = glm::min(minPos, threadMinPos[i]);
+		maxPos = glm::max(maxPos, threadMaxPos[i]);
+	}
+
+	switch (ordering)
+	{
+	case GaussianOrdering::NONE:
+		outputOrder.resize(numGaussians);
+		for (size_t i = 0; i < numGaussians; ++i)
+			outputOrder[i] = (uint32_t) i;
+		break;
+
+	case GaussianOrdering::MORTON_32:
+		ResourceManager::computeCurveOrderByKey<uint32_t>(
+			numGaussians, positionFunc, minPos, maxPos, numThreads, 10,
+			[](const glm::uvec3& p) { return SMath::encodeZorderCurve(p); },
+			outputOrder
+		);
+		break;
+
+	case GaussianOrdering::MORTON_64:
+		ResourceManager::computeCurveOrderByKey<uint64_t>(
+			numGaussians, positionFunc, minPos, maxPos, numThreads, SMath::WIDE_CURVE_BITS_PER_AXIS,
+			[](const glm::uvec3& p) { return SMath::encodeZorderCurveWide(p); },
+			outputOrder
+		);
+		break;
+
+	case GaussianOrdering::HILBERT:
+		ResourceManager::computeCurveOrderByKey<uint64_t>(
+			numGaussians, positionFunc, minPos, maxPos, numThreads, SMath::WIDE_CURVE_BITS_PER_AXIS,
+			[](const glm::uvec3& p) { return SMath::encodeHilbertCurve(p); },
+			outputOrder
+		);
+		break;
+	}
+}
+
+void ResourceManager::reorderGaussians(GaussianOrdering ordering)
+{
+	this->copyGaussiansToVector();
+
+	// Order
+	std::vector<uint32_t> order;
+	ResourceManager::computeCurveOrder(
+		ordering,
+		this->gaussians.size(),
+		[&](size_t i) { return glm::vec3(this->gaussians[i].position); },
+		order
+	);
+	if (this->useProgressiveLoading)
+	{
+		ResourceManager::applyImportanceBatches(
+			this->gaussians.size(),
+			[&](size_t i)
+			{
+				return ResourceManager::getGaussianImportance(
+					glm::vec3(this->gaussians[i].scale), 
+					this->gaussians[i].shCoeffs[0].a
+				);
+			},
+			order
+		);
+	}
+
+	// Gather gaussians into the new order
+	std::vector<GaussianData> sortedGaussians(this->gaussians.size());
+	ParallelFor::run(
+		this->gaussians.size(),
+		ParallelFor::getNumThreads(this->gaussians.size(), 16384),
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t i = beginIndex; i < endIndex; ++i)
+				sortedGaussians[i] = this->gaussians[order[i]];
+		}
+	);
+	this->gaussians.swap(sortedGaussians);
+	this->gaussianOrdering = ordering;
+}
+
+const char* ResourceManager::getGaussianOrderingName(GaussianOrdering ordering)
+{
+	switch (ordering)
+	{
+	case GaussianOrdering::NONE:
+		return "None";
+	case GaussianOrdering::MORTON_32:
+		return "Morton 32-bit";
+	case GaussianOrdering::MORTON_64:
+		return "Morton 64-bit";
+	case GaussianOrdering::HILBERT:
+		return "Hilbert";
+	}
+
+	return "Unknown";
+}
+
+uint32_t ResourceManager::getCacheOrderingId() const
+{
+	// Progressive loading changes the order of the cached gaussians
+	return (uint32_t) this->gaussianOrdering | 
+		(this->useProgressiveLoading ? PROGRESSIVE_CACHE_ORDERING_BIT : 0u);
+}
+
+bool ResourceManager::loadGaussiansFromCache(const std::string& filePath)
+{
+	Time::startTimer();
+
+	const std::string cacheFilePath = GaussianCache::getCacheFilePath(filePath);
+	if (!this->gaussianCache.open(cacheFilePath, filePath, this->getCacheOrderingId()))
+		return false;
+	this->gaussianShDegree = this->gaussianCache.getShDegree();
+
+	const float loadMs = Time::endTimer() * 1000.0f;
+	Log::write("Loaded gaussian cache in " + std::to_string(loadMs) + " ms: " + cacheFilePath);
+	Log::write("Number of gaussians: " + std::to_string(this->gaussianCache.getNumGaussians()) + ", spherical harmonics degree: " + std::to_string(this->gaussianShDegree));
+
+	return true;
+}
+
+void ResourceManager::copyGaussiansToVector()
+{
+	if (!this->gaussianCache.isOpen() && !this->gaussianPlyReader.isOpen())
+		return;
+
+	// Gaussians are about to be modified, so they can no longer be read from a mapped file
+	std::vector<GaussianData> decodedGaussians(this->getNumGaussians());
+	this->getGaussians(0, decodedGaussians.size(), decodedGaussians.data());
+
+	const uint32_t shDegree = this->gaussianShDegree;
+	this->clearAllGaussians();
+	this->gaussians.swap(decodedGaussians);
+	this->gaussianShDegree = shDegree;
+}
+
+size_t ResourceManager::getNumGaussians() const
+{
+	if (this->gaussianCache.isOpen())
+		return this->gaussianCache.getNumGaussians();
+	if (this->gaussianPlyReader.isOpen())
+		return this->gaussianPlyOrder.size();
+
+	return this->gaussians.size();
+}
+
+void ResourceManager::getGaussians(
+	size_t firstIndex,
+	size_t numGaussians,
+	GaussianData* output) const
+{
+	assert(firstIndex + numGaussians <= this->getNumGaussians());
+
+	// Pre-baked
+	if (this->gaussianCache.isOpen())
+	{
+		std::memcpy(output, this->gaussianCache.getGaussianData() + firstIndex, numGaussians * sizeof(GaussianData));
+	}
+	// Decode from .ply in the reordered order
+	else if (this->gaussianPlyReader.isOpen())
+	{
+		ParallelFor::run(
+			numGaussians,
+			ParallelFor::getNumThreads(numGaussians, 4096),
+			[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+			{
+				for (size_t i = beginIndex; i < endIndex; ++i)
+				{
+					ResourceManager::decodeGaussian(
+						this->gaussianPlyReader.getVertexRecord(this->gaussianPlyOrder[firstIndex + i]), 
+						this->gaussianPlyOffsets, 
+						output[i]
+					);
+				}
+			}
+		);
+	}
+	// Already decoded
+	else
+	{
+		std::memcpy(output, this->gaussians.data() + firstIndex, numGaussians * sizeof(GaussianData));
+	}
+}
+
 void ResourceManager::loadGaussians(const std::string& filePath)
 {
 	if (!std::filesystem::exists(filePath))
@@ -172,6 +684,257 @@ void ResourceManager::loadGaussians(const std::string& filePath)
 		return;
 	}
 
+	// Previously loaded gaussians are replaced
+	this->clearAllGaussians();
+
+#ifdef BENCHMARK_PLY_IMPORT
+	// Always parse the ply file, so the load below is timed as well
+	if (this->useGaussianCache)
+		Log::warning("BENCHMARK_PLY_IMPORT is defined, the gaussian cache is bypassed.");
+	this->benchmarkPlyImport(filePath);
+#else
+	// Use the pre-baked gaussians if they are up to date
+	if (this->useGaussianCache && this->loadGaussiansFromCache(filePath))
+		return;
+#endif
+
+	// Map ply file and parse header
+	if (!this->gaussianPlyReader.open(filePath))
+		return;
+	if (!this->getGaussianPlyOffsets(this->gaussianPlyReader, filePath, this->gaussianPlyOffsets))
+	{
+		this->gaussianPlyReader.close();
+		return;
+	}
+	this->gaussianFilePath = filePath;
+	this->gaussianShDegree = this->gaussianPlyOffsets.shDegree;
+
+	// Only positions (and the importance when loading progressively) are decoded here, 
+	// to order gaussians to be more cache coherent. The rest is decoded in chunks while uploading.
+	ResourceManager::computeCurveOrder(
+		this->gaussianOrdering,
+		this->gaussianPlyReader.getNumVertices(),
+		[&](size_t i) 
+		{ 
+			return ResourceManager::decodeGaussianPosition(
+				this->gaussianPlyReader.getVertexRecord(i), 
+				this->gaussianPlyOffsets
+			); 
+		},
+		this->gaussianPlyOrder
+	);
+	if (this->useProgressiveLoading)
+	{
+		ResourceManager::applyImportanceBatches(
+			this->gaussianPlyReader.getNumVertices(),
+			[&](size_t i)
+			{
+				return ResourceManager::decodeGaussianImportance(
+					this->gaussianPlyReader.getVertexRecord(i),
+					this->gaussianPlyOffsets
+				);
+			},
+			this->gaussianPlyOrder
+		);
+	}
+
+	Log::write("Number of gaussians: " + std::to_string(this->gaussianPlyOrder.size()) + ", spherical harmonics degree: " + std::to_string(this->gaussianShDegree));
+}
+
+void ResourceManager::uploadGaussians(
+	VkBuffer geometryBuffer, 
+	VkBuffer shBuffer, 
+	const std::function<void(size_t)>& progressCallback)
+{
+	const size_t numGaussians = this->getNumGaussians();
+	const bool decodeFromPly = this->gaussianPlyReader.isOpen();
+
+	// Store decoded gaussians for faster loading next time
+	GaussianCacheWriter cacheWriter;
+	if (decodeFromPly && this->useGaussianCache)
+	{
+		cacheWriter.begin(
+			GaussianCache::getCacheFilePath(this->gaussianFilePath),
+			this->gaussianFilePath,
+			this->getCacheOrderingId(),
+			this->gaussianShDegree,
+			numGaussians
+		);
+	}
+
+	// Each slot holds the geometry of a chunk, followed by its spherical harmonics
+	static_assert(GAUSSIAN_UPLOAD_CHUNK_SIZE % ShCompression::QUANTIZATION_CHUNK_SIZE == 0);
+	const ShStorageMode shMode = this->shStorageMode;
+	const uint32_t shDegree = this->gaussianShDegree;
+	const size_t shStagingOffset = GAUSSIAN_UPLOAD_CHUNK_SIZE * sizeof(GaussianGeometryData);
+	StagingRing stagingRing;
+	stagingRing.create(
+		*this->gfxAllocContext,
+		shStagingOffset + ShCompression::getStreamSize(shMode, shDegree, GAUSSIAN_UPLOAD_CHUNK_SIZE),
+		GAUSSIAN_UPLOAD_NUM_SLOTS
+	);
+
+	// Staging memory is write-combined, so gaussians are decoded into 
+	// cached memory first and then split into the streams in one sequential write. 
+	// Only the spherical harmonics up to the degree of the gaussians are stored.
+	std::vector<GaussianData> decodedChunk(GAUSSIAN_UPLOAD_CHUNK_SIZE);
+	std::vector<GaussianShData> shChunk(GAUSSIAN_UPLOAD_CHUNK_SIZE);
+#ifdef REPORT_SH_COMPRESSION_ERROR
+	// The error is measured from cached memory, before copying to staging memory
+	std::vector<uint8_t> encodedShChunk(ShCompression::getStreamSize(shMode, shDegree, GAUSSIAN_UPLOAD_CHUNK_SIZE));
+	ShCompressionError shError{};
+#endif
+
+	// The copy of one chunk runs on the GPU while the next chunk is decoded
+	for (size_t firstIndex = 0; firstIndex < numGaussians; firstIndex += GAUSSIAN_UPLOAD_CHUNK_SIZE)
+	{
+		const size_t numChunkGaussians = std::min(GAUSSIAN_UPLOAD_CHUNK_SIZE, numGaussians - firstIndex);
+
+		const size_t shStreamOffset = ShCompression::getStreamSize(shMode, shDegree, firstIndex);
+		const size_t shStreamSize = ShCompression::getStreamSize(shMode, shDegree, firstIndex + numChunkGaussians) - shStreamOffset;
+
+		uint8_t* stagingSlot = (uint8_t*) stagingRing.acquireSlot();
+		GaussianGeometryData* stagingGeometry = (GaussianGeometryData*) stagingSlot;
+		uint8_t* stagingSh = stagingSlot + shStagingOffset;
+
+		this->getGaussians(firstIndex, numChunkGaussians, decodedChunk.data());
+		if (cacheWriter.isWriting())
+			cacheWriter.write(decodedChunk.data(), numChunkGaussians);
+
+		// Threads work on whole quantization chunks, so each can encode its own range
+		const size_t numQuantizationChunks = 
+			(numChunkGaussians + ShCompression::QUANTIZATION_CHUNK_SIZE - 1) / ShCompression::QUANTIZATION_CHUNK_SIZE;
+		const uint32_t numThreads = ParallelFor::getNumThreads(numQuantizationChunks, 16);
+#ifdef REPORT_SH_COMPRESSION_ERROR
+		std::vector<ShCompressionError> threadShErrors(numThreads);
+#endif
+		ParallelFor::run(
+			numQuantizationChunks,
+			numThreads,
+			[&](uint32_t threadIndex, size_t beginChunk, size_t endChunk)
+			{
+				const size_t beginIndex = beginChunk * ShCompression::QUANTIZATION_CHUNK_SIZE;
+				const size_t endIndex = std::min(endChunk * ShCompression::QUANTIZATION_CHUNK_SIZE, numChunkGaussians);
+				if (beginIndex >= endIndex)
+					return;
+
+				for (size_t i = beginIndex; i < endIndex; ++i)
+					ResourceManager::splitGaussian(decodedChunk[i], stagingGeometry[i], shChunk[i]);
+
+				const size_t beginOffset = ShCompression::getStreamSize(shMode, shDegree, beginIndex);
+#ifdef REPORT_SH_COMPRESSION_ERROR
+				const size_t endOffset = ShCompression::getStreamSize(shMode, shDegree, endIndex);
+				ShCompression::encode(shMode, shDegree, &shChunk[beginIndex], endIndex - beginIndex, &encodedShChunk[beginOffset]);
+				ShCompression::measureError(
+					shMode, 
+					shDegree, 
+					&shChunk[beginIndex], 
+					endIndex - beginIndex, 
+					&encodedShChunk[beginOffset], 
+					threadShErrors[threadIndex]
+				);
+				std::memcpy(stagingSh + beginOffset, &encodedShChunk[beginOffset], endOffset - beginOffset);
+#else
+				ShCompression::encode(shMode, shDegree, &shChunk[beginIndex], endIndex - beginIndex, stagingSh + beginOffset);
+#endif
+			}
+		);
+#ifdef REPORT_SH_COMPRESSION_ERROR
+		for (size_t i = 0; i < threadShErrors.size(); ++i)
+			shError.add(threadShErrors[i]);
+#endif
+
+		std::array<StagingRingCopy, 2> copies{};
+		copies[0].dstBuffer = geometryBuffer;
+		copies[0].srcOffset = 0;
+		copies[0].dstOffset = firstIndex * sizeof(GaussianGeometryData);
+		copies[0].numBytes = numChunkGaussians * sizeof(GaussianGeometryData);
+		copies[1].dstBuffer = shBuffer;
+		copies[1].srcOffset = shStagingOffset;
+		copies[1].dstOffset = shStreamOffset;
+		copies[1].numBytes = shStreamSize;
+		stagingRing.submitSlot(copies.data(), (uint32_t) copies.size());
+
+		if (progressCallback)
+			progressCallback(firstIndex + numChunkGaussians);
+	}
+
+	stagingRing.cleanup();
+	cacheWriter.end();
+
+#ifdef REPORT_SH_COMPRESSION_ERROR
+	Log::write(
+		"Spherical harmonics stored as " + std::string(ShCompression::getModeName(shMode)) + 
+		" (" + std::to_string(ShCompression::getStreamSize(shMode, shDegree, numGaussians) / std::max(numGaussians, size_t(1))) + " bytes per gaussian), " +
+		"color error max: " + std::to_string(shError.maxColorDelta) + 
+		", mean: " + std::to_string(shError.getMeanColorDelta())
+	);
+#endif
+}
+
+#ifdef BENCHMARK_PLY_IMPORT
+void ResourceManager::benchmarkPlyImport(const std::string& filePath)
+{
+	// Decode every gaussian through the memory mapped reader
+	Time::startTimer();
+	PlyReader plyReader;
+	GaussianPlyOffsets offsets{};
+	if (!plyReader.open(filePath) || !this->getGaussianPlyOffsets(plyReader, filePath, offsets))
+		return;
+	std::vector<GaussianData> mappedGaussians(plyReader.getNumVertices());
+	ParallelFor::run(
+		mappedGaussians.size(),
+		ParallelFor::getNumThreads(mappedGaussians.size(), 16384),
+		[&](uint32_t threadIndex, size_t beginIndex, size_t endIndex)
+		{
+			for (size_t i = beginIndex; i < endIndex; ++i)
+				ResourceManager::decodeGaussian(plyReader.getVertexRecord(i), offsets, mappedGaussians[i]);
+		}
+	);
+	const float mappedMs = Time::endTimer() * 1000.0f;
+	const double fileSizeMb = double(plyReader.getFileSize()) / (1024.0 * 1024.0);
+
+	// Load the same file through hapPLY
+	std::vector<GaussianData> happlyGaussians;
+	Time::startTimer();
+	this->loadGaussiansHapply(filePath, happlyGaussians);
+	const float happlyMs = Time::endTimer() * 1000.0f;
+
+	// Both paths should produce the same data, apart from the 
+	// small error in the vectorized exp. Spherical harmonics are copied 
+	// without any activation, so they should match exactly.
+	const bool sameCount = happlyGaussians.size() == mappedGaussians.size();
+	float maxRelativeError = sameCount ? 0.0f : std::numeric_limits<float>::max();
+	float maxShError = sameCount ? 0.0f : std::numeric_limits<float>::max();
+	for (size_t i = 0; i < happlyGaussians.size() && i < mappedGaussians.size(); ++i)
+	{
+		const GaussianData& a = happlyGaussians[i];
+		const GaussianData& b = mappedGaussians[i];
+		const glm::vec4 valuesA(glm::vec3(a.scale), a.shCoeffs[0].a);
+		const glm::vec4 valuesB(glm::vec3(b.scale), b.shCoeffs[0].a);
+		const glm::vec4 relativeError = glm::abs(valuesA - valuesB) / glm::max(glm::abs(valuesA), glm::vec4(1e-30f));
+
+		maxRelativeError = std::max(maxRelativeError, std::max(std::max(relativeError.x, relativeError.y), std::max(relativeError.z, relativeError.w)));
+
+		for (uint32_t c = 0; c < GaussianShData::NUM_COEFFS; ++c)
+		{
+			const glm::vec3 shError = glm::abs(glm::vec3(a.shCoeffs[c]) - glm::vec3(b.shCoeffs[c]));
+			maxShError = std::max(maxShError, std::max(shError.x, std::max(shError.y, shError.z)));
+		}
+	}
+
+	Log::write("PLY import benchmark (" + std::to_string(fileSizeMb) + " MB)");
+	Log::write("    Memory mapped: " + std::to_string(mappedMs) + " ms (" + std::to_string(fileSizeMb / (mappedMs * 0.001)) + " MB/s)");
+	Log::write("    hapPLY: " + std::to_string(happlyMs) + " ms (" + std::to_string(fileSizeMb / (happlyMs * 0.001)) + " MB/s)");
+	Log::write("    Speedup: " + std::to_string(happlyMs / mappedMs) + "x");
+	Log::write("    Max relative scale/opacity error: " + std::to_string(maxRelativeError));
+	Log::write("    Max spherical harmonics error: " + std::to_string(maxShError));
+}
+
+void ResourceManager::loadGaussiansHapply(
+	const std::string& filePath, 
+	std::vector<GaussianData>& output)
+{
 	// Load ply file
 	happly::PLYData plyData(filePath);
 
@@ -213,7 +976,13 @@ void ResourceManager::loadGaussians(const std::string& filePath)
 	this->loadPlyProperty<float>(element, "f_dc_1", gGreenSh00);
 	this->loadPlyProperty<float>(element, "f_dc_2", gBlueSh00);
 
-	uint32_t numRestCoeffs = 15;
+	// Same "f_rest_*" property count as getGaussianPlyOffsets()
+	uint32_t numRestFloats = 0;
+	while (element.hasProperty("f_rest_" + std::to_string(numRestFloats)))
+		numRestFloats++;
+	uint32_t numRestCoeffs = numRestFloats / 3;
+	if (numRestCoeffs > GaussianPlyOffsets::MAX_SH_REST_COEFFS)
+		numRestCoeffs = GaussianPlyOffsets::MAX_SH_REST_COEFFS;
 	std::vector<std::vector<float>> gShRest(numRestCoeffs * 3);
 	for (size_t i = 0; i < gShRest.size(); ++i)
 	{
@@ -221,12 +990,10 @@ void ResourceManager::loadGaussians(const std::string& filePath)
 	}
 
 	uint32_t numGaussians = (uint32_t)gPositionsX.size();
-	this->gaussians.resize(numGaussians);
-	glm::vec3 minPos(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-	glm::vec3 maxPos(std::numeric_limits<float>::min(), std::numeric_limits<float>::min(), std::numeric_limits<float>::min());
+	output.resize(numGaussians);
 	for (uint32_t i = 0; i < numGaussians; ++i)
 	{
-		GaussianData& gaussian = this->gaussians[i];
+		GaussianData& gaussian = output[i];
 
 		gaussian.position = glm::vec4(
 			gPositionsX[i] * -1.0f,
@@ -271,30 +1038,6 @@ void ResourceManager::loadGaussians(const std::string& filePath)
 				0.0f
 			);
 		}
-
-		maxPos.x = std::max(maxPos.x, gaussian.position.x);
-		maxPos.y = std::max(maxPos.y, gaussian.position.y);
-		maxPos.z = std::max(maxPos.z, gaussian.position.z);
-
-		minPos.x = std::min(minPos.x, gaussian.position.x);
-		minPos.y = std::min(minPos.y, gaussian.position.y);
-		minPos.z = std::min(minPos.z, gaussian.position.z);
 	}
-	const glm::vec3 deltaMinMax = maxPos - minPos;
-	const uint32_t mortonSpaceSize = (1 << 10) - 1;
-
-	// Sort gaussians to be more cache coherent
-	std::sort(
-		std::begin(this->gaussians), 
-		std::end(this->gaussians), 
-		[&](const GaussianData& a, const GaussianData& b) 
-		{
-			const glm::vec3 mortonSpacePosA = (glm::vec3(a.position) - minPos) / deltaMinMax * (float) mortonSpaceSize;
-			const glm::vec3 mortonSpacePosB = (glm::vec3(b.position) - minPos) / deltaMinMax * (float) mortonSpaceSize;
-
-			return SMath::encodeZorderCurve(glm::uvec3(mortonSpacePosA)) < SMath::encodeZorderCurve(glm::uvec3(mortonSpacePosB));
-		}
-	);
-
-	Log::write("Number of gaussians: " + std::to_string(this->gaussians.size()));
 }
+#endif
\ No newline at end of file
@@ -1,32 +1,162 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 #include <vector>
-#include <happly.h>
 
 #include "Graphics/Mesh.h"
 #include "Graphics/Texture/Texture.h"
+#include "Graphics/GaussianCache.h"
+#include "Graphics/PlyReader.h"
+#include "Graphics/ShCompression.h"
 #include "Components.h"
 
+// Imports .ply files through both the memory mapped reader and hapPLY, 
+// and prints the throughput of each
+//#define BENCHMARK_PLY_IMPORT
+
+#ifdef BENCHMARK_PLY_IMPORT
+#include <happly.h>
+#endif
+
+// Prints the color error of the compressed spherical harmonics after uploading
+//#define REPORT_SH_COMPRESSION_ERROR
+
 struct GfxAllocContext;
 
+// Order of gaussians in memory after import, for cache coherency on the GPU
+enum class GaussianOrdering
+{
+	NONE = 0,		// Same order as the file
+	MORTON_32 = 1,	// Z-order curve, 10 bits per axis
+	MORTON_64 = 2,	// Z-order curve, 21 bits per axis
+	HILBERT = 3		// Hilbert curve, 21 bits per axis
+};
+
+// Byte offsets of the gaussian properties within one .ply vertex record
+struct GaussianPlyOffsets
+{
+	static const uint32_t MAX_SH_REST_COEFFS = GaussianShData::NUM_COEFFS - 1;
+
+	uint32_t shDegree;
+	uint32_t numShRestCoeffs; // Per color channel
+
+	uint32_t position[3];
+	uint32_t scale[3];
+	uint32_t rot[4];
+	uint32_t opacity;
+	uint32_t shDc[3];
+	uint32_t shRest[MAX_SH_REST_COEFFS * 3];
+};
+
 class ResourceManager
 {
 private:
+	static const size_t GAUSSIAN_UPLOAD_CHUNK_SIZE = 1 << 16;
+	static const uint32_t GAUSSIAN_UPLOAD_NUM_SLOTS = 3;
+
+	// Progressive loading uploads gaussians in batches of decreasing importance, 
+	// where each batch is twice as large as the one before
+	static const size_t PROGRESSIVE_FIRST_BATCH_SIZE = GAUSSIAN_UPLOAD_CHUNK_SIZE;
+	static const uint32_t PROGRESSIVE_CACHE_ORDERING_BIT = 1u << 31;
+
 	std::unordered_map<std::string, uint32_t> nameToTexture;
 	std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> nameToMesh; // { meshId, defaultMaterialId }
 
 	std::vector<std::shared_ptr<Texture>> textures;
 	std::vector<Mesh> meshes;
+
+	// Gaussians are kept in one of these sources until uploaded to the GPU:
+	// - Added manually or already decoded
 	std::vector<GaussianData> gaussians;
+	// - Mapped directly from a pre-baked cache file
+	GaussianCache gaussianCache;
+	// - Mapped .ply file, decoded in chunks during upload. 
+	//   gaussianPlyOrder holds the vertex index of each gaussian after reordering.
+	PlyReader gaussianPlyReader;
+	GaussianPlyOffsets gaussianPlyOffsets;
+	std::vector<uint32_t> gaussianPlyOrder;
+	std::string gaussianFilePath;
 
 	const GfxAllocContext* gfxAllocContext;
 
+	GaussianOrdering gaussianOrdering;
+	bool useGaussianCache;
+	bool useProgressiveLoading;
+	ShStorageMode shStorageMode;
+	uint32_t gaussianShDegree;
+
+	uint32_t getCacheOrderingId() const;
+
+	bool loadGaussiansFromCache(const std::string& filePath);
+	void copyGaussiansToVector();
+
+	void getGaussians(
+		size_t firstIndex, 
+		size_t numGaussians, 
+		GaussianData* output) const;
+
+	bool getGaussianPlyOffsets(
+		const PlyReader& plyReader, 
+		const std::string& filePath, 
+		GaussianPlyOffsets& output) const;
+
+	template <typename PositionFunc>
+	static void computeCurveOrder(
+		GaussianOrdering ordering, 
+		size_t numGaussians, 
+		const PositionFunc& positionFunc, 
+		std::vector<uint32_t>& outputOrder);
+
+	template <typename KeyType, typename PositionFunc, typename EncodeFunc>
+	static void computeCurveOrderByKey(
+		size_t numGaussians, 
+		const PositionFunc& positionFunc, 
+		const glm::vec3& minPos, 
+		const glm::vec3& maxPos, 
+		uint32_t numThreads, 
+		uint32_t numBitsPerAxis, 
+		const EncodeFunc& encodeFunc, 
+		std::vector<uint32_t>& outputOrder);
+
+	template <typename ImportanceFunc>
+	static void applyImportanceBatches(
+		size_t numGaussians, 
+		const ImportanceFunc& importanceFunc, 
+		std::vector<uint32_t>& order);
+
+	static float getGaussianImportance(const glm::vec3& scale, float opacity);
+
+	static glm::vec3 decodeGaussianPosition(
+		const uint8_t* vertexRecord, 
+		const GaussianPlyOffsets& offsets);
+
+	static float decodeGaussianImportance(
+		const uint8_t* vertexRecord, 
+		const GaussianPlyOffsets& offsets);
+
+	static void decodeGaussian(
+		const uint8_t* vertexRecord, 
+		const GaussianPlyOffsets& offsets, 
+		GaussianData& output);
+
+	static void splitGaussian(
+		const GaussianData& gaussian, 
+		GaussianGeometryData& outputGeometry, 
+		GaussianShData& outputSh);
+
+#ifdef BENCHMARK_PLY_IMPORT
+	void benchmarkPlyImport(const std::string& filePath);
+	void loadGaussiansHapply(
+		const std::string& filePath, 
+		std::vector<GaussianData>& output);
+
 	template <typename T>
 	void loadPlyProperty(
 		happly::Element& element, 
 		const std::string& propertyStr, 
 		std::vector<T>& output);
+#endif
 
 public:
 	ResourceManager();
@@ -47,15 +177,39 @@ public:
 	uint32_t addGaussian(const GaussianData& gaussianData);
 	
 	void loadGaussians(const std::string& filePath);
+	void reorderGaussians(GaussianOrdering ordering);
+
+	// Streams all gaussians into the geometry and spherical harmonics buffers 
+	// through a ring of staging buffers. The optional callback receives the 
+	// number of gaussians submitted for upload after each chunk.
+	void uploadGaussians(
+		VkBuffer geometryBuffer, 
+		VkBuffer shBuffer, 
+		const std::function<void(size_t)>& progressCallback = nullptr);
+
+	inline void setGaussianOrdering(GaussianOrdering ordering) { this->gaussianOrdering = ordering; }
+	inline void setUseGaussianCache(bool useCache) { this->useGaussianCache = useCache; }
+	inline void setUseProgressiveLoading(bool useProgressive) { this->useProgressiveLoading = useProgressive; }
+
+	// Has to be set before the renderer is initialized, 
+	// since InitSortList is specialized for the storage mode
+	inline void setShStorageMode(ShStorageMode storageMode) { this->shStorageMode = storageMode; }
+
+	static const char* getGaussianOrderingName(GaussianOrdering ordering);
 
 	inline Mesh& getMesh(uint32_t meshID) { return this->meshes[meshID]; }
 	inline Texture* getTexture(uint32_t textureID) { return this->textures[textureID].get(); }
-	inline const std::vector<GaussianData>& getGaussians() const { return this->gaussians; }
+	size_t getNumGaussians() const;
 
 	inline size_t getNumMeshes() const { return this->meshes.size(); }
 	inline size_t getNumTextures() const { return this->textures.size(); }
+	inline GaussianOrdering getGaussianOrdering() const { return this->gaussianOrdering; }
+	inline bool getUseProgressiveLoading() const { return this->useProgressiveLoading; }
+	inline ShStorageMode getShStorageMode() const { return this->shStorageMode; }
+	inline uint32_t getGaussianShDegree() const { return this->gaussianShDegree; }
 };
 
+#ifdef BENCHMARK_PLY_IMPORT
 template<typename T>
 inline void ResourceManager::loadPlyProperty(
 	happly::Element& element,
@@ -68,4 +222,5 @@ inline void ResourceManager::loadPlyProperty(
 	assert(hasProperty);
 
 	output = element.getProperty<T>(propertyStr);
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
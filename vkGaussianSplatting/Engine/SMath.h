@@ -3,6 +3,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SMATH_SSE2
+#endif
+
 class SMath
 {
 private:
@@ -17,7 +22,21 @@ private:
 		return x;
 	}
 
+	// 21 bit version of mortonPartBy2, for 64 bit keys
+	static inline uint64_t mortonPartBy2Wide(uint64_t x)
+	{
+		x &= 0x00000000001fffffull;
+		x = (x ^ (x << 32)) & 0x001f00000000ffffull;
+		x = (x ^ (x << 16)) & 0x001f0000ff0000ffull;
+		x = (x ^ (x <<  8)) & 0x100f00f00f00f00full;
+		x = (x ^ (x <<  4)) & 0x10c30c30c30c30c3ull;
+		x = (x ^ (x <<  2)) & 0x1249249249249249ull;
+		return x;
+	}
+
 public:
+	static const uint32_t WIDE_CURVE_BITS_PER_AXIS = 21;
+
 	static const float PI;
 
 	static float roundToThreeDecimals(float x);
@@ -32,4 +51,105 @@ public:
 			(SMath::mortonPartBy2(position.y) << 1) + 
 			SMath::mortonPartBy2(position.x);
 	}
+	static inline uint64_t encodeZorderCurveWide(glm::uvec3 position)
+	{
+		// 21 bits per component to produce 63 bit key
+		assert(position.x < (1u << WIDE_CURVE_BITS_PER_AXIS));
+		assert(position.y < (1u << WIDE_CURVE_BITS_PER_AXIS));
+		assert(position.z < (1u << WIDE_CURVE_BITS_PER_AXIS));
+
+		return (SMath::mortonPartBy2Wide(position.z) << 2) +
+			(SMath::mortonPartBy2Wide(position.y) << 1) +
+			SMath::mortonPartBy2Wide(position.x);
+	}
+
+	// Source: J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707 (2004)
+	static inline uint64_t encodeHilbertCurve(glm::uvec3 position)
+	{
+		// 21 bits per component to produce 63 bit key
+		assert(position.x < (1u << WIDE_CURVE_BITS_PER_AXIS));
+		assert(position.y < (1u << WIDE_CURVE_BITS_PER_AXIS));
+		assert(position.z < (1u << WIDE_CURVE_BITS_PER_AXIS));
+
+		uint32_t x[3] = { position.x, position.y, position.z };
+
+		// Inverse undo excess work
+		for (uint32_t q = 1u << (WIDE_CURVE_BITS_PER_AXIS - 1); q > 1; q >>= 1)
+		{
+			const uint32_t p = q - 1;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if (x[i] & q)
+				{
+					x[0] ^= p; // Invert
+				}
+				else
+				{
+					// Exchange
+					const uint32_t t = (x[0] ^ x[i]) & p;
+					x[0] ^= t;
+					x[i] ^= t;
+				}
+			}
+		}
+
+		// Gray encode
+		x[1] ^= x[0];
+		x[2] ^= x[1];
+		uint32_t t = 0;
+		for (uint32_t q = 1u << (WIDE_CURVE_BITS_PER_AXIS - 1); q > 1; q >>= 1)
+		{
+			if (x[2] & q)
+				t ^= q - 1;
+		}
+		x[0] ^= t;
+		x[1] ^= t;
+		x[2] ^= t;
+
+		// Interleave the transposed index, with x[0] holding the most significant bits
+		return (SMath::mortonPartBy2Wide(x[0]) << 2) +
+			(SMath::mortonPartBy2Wide(x[1]) << 1) +
+			SMath::mortonPartBy2Wide(x[2]);
+	}
+
+	// Exponential of 4 floats at once. Polynomial approximation from Cephes expf, 
+	// with a relative error below 1e-7 compared to std::exp.
+	static inline glm::vec4 exp4(const glm::vec4& x)
+	{
+#ifdef SMATH_SSE2
+		// Clamp so that 2^n stays within the normalized float range
+		__m128 v = _mm_loadu_ps(&x[0]);
+		v = _mm_min_ps(v, _mm_set1_ps(88.0f));
+		v = _mm_max_ps(v, _mm_set1_ps(-87.0f));
+
+		// exp(x) = 2^n * exp(r), n = floor(x / ln(2) + 0.5)
+		__m128 fx = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+		__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+		fx = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, fx), _mm_set1_ps(1.0f)));
+
+		// r = x - n * ln(2), with ln(2) split in two for precision
+		v = _mm_sub_ps(v, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+		v = _mm_sub_ps(v, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+
+		// exp(r)
+		const __m128 r2 = _mm_mul_ps(v, v);
+		__m128 y = _mm_set1_ps(1.9875691500e-4f);
+		y = _mm_add_ps(_mm_mul_ps(y, v), _mm_set1_ps(1.3981999507e-3f));
+		y = _mm_add_ps(_mm_mul_ps(y, v), _mm_set1_ps(8.3334519073e-3f));
+		y = _mm_add_ps(_mm_mul_ps(y, v), _mm_set1_ps(4.1665795894e-2f));
+		y = _mm_add_ps(_mm_mul_ps(y, v), _mm_set1_ps(1.6666665459e-1f));
+		y = _mm_add_ps(_mm_mul_ps(y, v), _mm_set1_ps(5.0000001201e-1f));
+		y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, r2), v), _mm_set1_ps(1.0f));
+
+		// 2^n, built directly from the float exponent bits
+		__m128i n = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(127));
+		const __m128 pow2n = _mm_castsi128_ps(_mm_slli_epi32(n, 23));
+
+		glm::vec4 result;
+		_mm_storeu_ps(&result[0], _mm_mul_ps(y, pow2n));
+		return result;
+#else
+		return glm::vec4(std::exp(x.x), std::exp(x.y), std::exp(x.z), std::exp(x.w));
+#endif
+	}
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include <stdexcept>
+#include <sstream>
 #include "Engine/Engine.h"
+#include "Engine/Dev/SelfTest.h"
 
 #include "Scenes/BicycleScene.h"
 #include "Scenes/GardenScene.h"
@@ -8,17 +10,62 @@
 #include "Scenes/TestSortScene.h"
 #include "Scenes/TrainScene.h"
 
-int main()
+// Runs the sort benchmark instead of a scene:
+// --sort-benchmark [--sizes 262144,1048576] [--iterations 20]
+bool parseSortBenchmarkArgs(int argc, char* argv[], SortBenchmarkSettings& outputSettings)
+{
+	bool runBenchmark = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--sort-benchmark")
+		{
+			runBenchmark = true;
+		}
+		else if (arg == "--sizes" && i + 1 < argc)
+		{
+			outputSettings.numSortElements.clear();
+
+			std::stringstream sizes(argv[++i]);
+			std::string size;
+			while (std::getline(sizes, size, ','))
+				outputSettings.numSortElements.push_back(uint32_t(std::stoul(size)));
+		}
+		else if (arg == "--iterations" && i + 1 < argc)
+		{
+			outputSettings.numIterations = std::max(uint32_t(std::stoul(argv[++i])), 1u);
+		}
+	}
+
+	return runBenchmark;
+}
+
+int main(int argc, char* argv[])
 {
 	// Set flags for tracking CPU memory leaks
 	#ifdef _DEBUG
 		_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 	#endif
 
+	// Checks of the CPU side code, without creating the engine
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--self-test")
+		{
+			SelfTest selfTest;
+			return selfTest.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
 	// Create engine within it's own scope
 	{
 		Engine engine;
-		engine.init(new GardenScene());
+
+		SortBenchmarkSettings sortBenchmarkSettings;
+		if (parseSortBenchmarkArgs(argc, argv, sortBenchmarkSettings))
+			engine.runSortBenchmark(sortBenchmarkSettings);
+		else
+			engine.init(new GardenScene());
 	}
 
 	// Display validation errors right after exit
@@ -14,6 +14,18 @@
 // 2^32 - 1
 #define MAX_UINT32 4294967295u
 
+// Tile extents uvec4(minX, minY, maxX, maxY) packed into 8 bits each 
+// (grids of at most 255x255 tiles)
+uint packTileRect(uvec4 tileExtents)
+{
+	return tileExtents.x | (tileExtents.y << 8u) | (tileExtents.z << 16u) | (tileExtents.w << 24u);
+}
+
+uvec4 unpackTileRect(uint tileRect)
+{
+	return uvec4(tileRect & 0xFFu, (tileRect >> 8u) & 0xFFu, (tileRect >> 16u) & 0xFFu, tileRect >> 24u);
+}
+
 mat3x3 getRotMat(vec4 rot)
 {
 	const float r = rot.x;
@@ -88,10 +100,12 @@ vec4 getScreenSpacePosition(float width, float height, vec4 gPosV, mat4 projMat)
 	return screenSpacePos;
 }
 
-// Efficient SH basis function evaluation for the first 16 coefficients
+// Efficient SH basis function evaluation for the first numShCoeffs (1, 4, 9 or 16) coefficients.
 // Based on "Efficient Spherical Harmonic Evaluation" by Peter-Pike Sloan
 // https://www.ppsloan.org/publications/SHJCGT.pdf
-void getShEval4(const vec3 evalDir, inout float pSH[16])
+// The terms are grouped per band, so bands above the degree of the scene 
+// are skipped when numShCoeffs is a specialization constant.
+void getShEval(const vec3 evalDir, const uint numShCoeffs, inout float pSH[16])
 {
 	// Rotate evaluation direction
 	float fX, fY, fZ;
@@ -100,71 +114,71 @@ void getShEval4(const vec3 evalDir, inout float pSH[16])
 		fY = -evalDir.y;
 		fZ = evalDir.z;
 	}
-
-	float fC0,fC1,fS0,fS1,fTmpA,fTmpB,fTmpC;
 	float fZ2 = fZ*fZ;
 
 	pSH[0] = 0.2820947917738781f;
-	pSH[2] = 0.4886025119029199f*fZ;
-	pSH[6] = 0.9461746957575601f*fZ2 + -0.31539156525252f;
-	pSH[12] = fZ*(1.865881662950577f*fZ2 + -1.119528997770346f);
-	fC0 = fX;
-	fS0 = fY;
-
-	fTmpA = -0.48860251190292f;
-	pSH[3] = fTmpA*fC0;
-	pSH[1] = fTmpA*fS0;
-	fTmpB = -1.092548430592079f*fZ;
-	pSH[7] = fTmpB*fC0;
-	pSH[5] = fTmpB*fS0;
-	fTmpC = -2.285228997322329f*fZ2 + 0.4570457994644658f;
-	pSH[13] = fTmpC*fC0;
-	pSH[11] = fTmpC*fS0;
-	fC1 = fX*fC0 - fY*fS0;
-	fS1 = fX*fS0 + fY*fC0;
-
-	fTmpA = 0.5462742152960395f;
-	pSH[8] = fTmpA*fC1;
-	pSH[4] = fTmpA*fS1;
-	fTmpB = 1.445305721320277f*fZ;
-	pSH[14] = fTmpB*fC1;
-	pSH[10] = fTmpB*fS1;
-	fC0 = fX*fC1 - fY*fS1;
-	fS0 = fX*fS1 + fY*fC1;
-
-	fTmpC = -0.5900435899266435f;
-	pSH[15] = fTmpC*fC0;
-	pSH[9] = fTmpC*fS0;
+	if (numShCoeffs >= 4)
+	{
+		float fTmpA = -0.48860251190292f;
+		pSH[1] = fTmpA*fY;
+		pSH[2] = 0.4886025119029199f*fZ;
+		pSH[3] = fTmpA*fX;
+	}
+	if (numShCoeffs >= 9)
+	{
+		float fC1 = fX*fX - fY*fY;
+		float fS1 = 2.0f*fX*fY;
+		float fTmpA = 0.5462742152960395f;
+		float fTmpB = -1.092548430592079f*fZ;
+		pSH[4] = fTmpA*fS1;
+		pSH[5] = fTmpB*fY;
+		pSH[6] = 0.9461746957575601f*fZ2 + -0.31539156525252f;
+		pSH[7] = fTmpB*fX;
+		pSH[8] = fTmpA*fC1;
+
+		if (numShCoeffs >= 16)
+		{
+			float fC0 = fX*fC1 - fY*fS1;
+			float fS0 = fX*fS1 + fY*fC1;
+			float fTmpB3 = 1.445305721320277f*fZ;
+			float fTmpC = -2.285228997322329f*fZ2 + 0.4570457994644658f;
+			float fTmpD = -0.5900435899266435f;
+			pSH[9] = fTmpD*fS0;
+			pSH[10] = fTmpB3*fS1;
+			pSH[11] = fTmpC*fY;
+			pSH[12] = fZ*(1.865881662950577f*fZ2 + -1.119528997770346f);
+			pSH[13] = fTmpC*fX;
+			pSH[14] = fTmpB3*fC1;
+			pSH[15] = fTmpD*fC0;
+		}
+	}
 }
 
+// Maximum number of coefficients, for degree 3
 #define NUM_SH_COEFFS 16
-vec3 getShColor(vec3 evalDir, vec4 shCoeffs[NUM_SH_COEFFS], uint sphericalHarmonicsMode)
+vec3 getShColor(vec3 evalDir, vec3 shCoeffs[NUM_SH_COEFFS], const uint numShCoeffs, uint sphericalHarmonicsMode)
 {
-#if NUM_SH_COEFFS == 16
-
 	float shBasisValues[NUM_SH_COEFFS];
-	getShEval4(evalDir, shBasisValues);
+	getShEval(evalDir, numShCoeffs, shBasisValues);
 
 	vec3 result = vec3(0.0f);
 	if (sphericalHarmonicsMode == 0)		// All bands
 	{
-		for (int i = 0; i < NUM_SH_COEFFS; ++i)
-			result += shCoeffs[i].xyz * shBasisValues[i];
+		for (uint i = 0; i < numShCoeffs; ++i)
+			result += shCoeffs[i] * shBasisValues[i];
 	}
 	else if (sphericalHarmonicsMode == 1)	// Skip first band
 	{
-		for (int i = 1; i < NUM_SH_COEFFS; ++i)
-			result += shCoeffs[i].xyz * shBasisValues[i];
+		for (uint i = 1; i < numShCoeffs; ++i)
+			result += shCoeffs[i] * shBasisValues[i];
 		result -= vec3(0.5f);
 	}
 	else if (sphericalHarmonicsMode == 2)	// Only first band
 	{
-		result += shCoeffs[0].xyz * shBasisValues[0];
+		result += shCoeffs[0] * shBasisValues[0];
 	}
 
 	result += vec3(0.5f);
 	result = max(result, vec3(0.0f));
 	return result;
-
-#endif
 }
\ No newline at end of file
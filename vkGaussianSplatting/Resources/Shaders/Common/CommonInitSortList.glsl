@@ -0,0 +1,75 @@
+// Has to reflect the INIT_LIST_* constants in Renderer.h
+#define INIT_LIST_SCAN_WORK_GROUP_SIZE 256
+#define INIT_LIST_SCAN_ITEMS_PER_THREAD 4
+#define INIT_LIST_SCAN_BLOCK_SIZE (INIT_LIST_SCAN_WORK_GROUP_SIZE * INIT_LIST_SCAN_ITEMS_PER_THREAD)
+#define INIT_LIST_BLOCK_SCAN_WORK_GROUP_SIZE 1024
+
+// Requires GL_EXT_shader_explicit_arithmetic_types_int64. 
+// Compact keys store the tile index in the highest bits of the lower 32 bits, 
+// and drop the lowest bits of the depth to make room.
+uint64_t getSortKey(uint tileKey, uint depthKey, uint numCompactTileBits)
+{
+	if(numCompactTileBits > 0u)
+		return uint64_t((tileKey << (32u - numCompactTileBits)) | (depthKey >> numCompactTileBits));
+
+	return (uint64_t(tileKey) << 32u) | uint64_t(depthKey);
+}
+
+// Splats are cut off where alpha = opacity * exp(-0.5 * d^T * conic * d) drops below 1/255, 
+// exactly where RenderGaussians stops blending them (at most 2 * ln(255), about 3.33 
+// standard deviations, at full opacity). Returns the limit of d^T * conic * d, 
+// which is not positive for splats that are never visible.
+float getSplatExtentThreshold(float opacity)
+{
+	return 2.0f * log(255.0f * opacity);
+}
+
+// Exact test of the ellipse d^T * conic * d <= threshold against the pixels of a tile, 
+// where d = (screenPos.x - pixel.x, pixel.y - screenPos.y) as in RenderGaussians. 
+// Precise, so that every pass testing the same splat counts the same tiles.
+bool isSplatOverlappingTile(vec2 screenPos, vec3 conic, float threshold, uvec2 tile)
+{
+	// Pixels are at integer coordinates
+	precise vec2 tileMin = vec2(tile * uvec2(TILE_SIZE));
+	precise vec2 tileMax = tileMin + vec2(float(TILE_SIZE - 1));
+	precise vec2 dMin = vec2(screenPos.x - tileMax.x, tileMin.y - screenPos.y);
+	precise vec2 dMax = vec2(screenPos.x - tileMin.x, tileMax.y - screenPos.y);
+
+	// Center within the tile, or a degenerate conic kept conservatively
+	if((dMin.x <= 0.0f && dMax.x >= 0.0f && dMin.y <= 0.0f && dMax.y >= 0.0f) || 
+		conic.x <= 0.0f || conic.z <= 0.0f)
+		return true;
+
+	// Otherwise the closest point is on an edge. Along an edge, the quadratic form 
+	// is a parabola, minimized by clamping its vertex to the edge.
+	precise float minValue = threshold + 1.0f;
+	for(uint i = 0u; i < 2u; ++i)
+	{
+		precise float dx = i == 0u ? dMin.x : dMax.x;
+		precise float dy = clamp(-conic.y * dx / conic.z, dMin.y, dMax.y);
+		minValue = min(minValue, conic.x * dx * dx + 2.0f * conic.y * dx * dy + conic.z * dy * dy);
+
+		dy = i == 0u ? dMin.y : dMax.y;
+		dx = clamp(-conic.y * dy / conic.x, dMin.x, dMax.x);
+		minValue = min(minValue, conic.x * dx * dx + 2.0f * conic.y * dx * dy + conic.z * dy * dy);
+	}
+
+	return minValue <= threshold;
+}
+
+// Number of tiles within the extents that get an element
+uint getNumSplatElements(uvec4 extents, vec2 screenPos, vec4 conicOpacity)
+{
+	const float threshold = getSplatExtentThreshold(conicOpacity.w);
+	uint numElements = 0u;
+	for(uint y = extents.y; y < extents.w; ++y)
+	{
+		for(uint x = extents.x; x < extents.z; ++x)
+		{
+			if(isSplatOverlappingTile(screenPos, conicOpacity.xyz, threshold, uvec2(x, y)))
+				numElements++;
+		}
+	}
+
+	return numElements;
+}
@@ -0,0 +1,11 @@
+#define TILE_RANGE_SCAN_WORK_GROUP_SIZE 1024
+
+// Requires GL_EXT_shader_explicit_arithmetic_types_int64. 
+// Mirrors the key layouts written by InitSortList.
+uint getSortKeyTileIndex(uint64_t key, uint numCompactTileBits)
+{
+	if(numCompactTileBits > 0u)
+		return uint(key) >> (32u - numCompactTileBits);
+
+	return uint(key >> 32u);
+}
\ No newline at end of file
@@ -1,27 +1,51 @@
-// Data per gaussian
-struct GaussianData
+// Geometry per gaussian, read by every pass
+struct GaussianGeometryData
 {
-	// These remain unmodified
-	vec4 position;
+	vec4 position; // vec4(x, y, z, alpha)
 	vec4 scale;
 	vec4 rot;
-	vec4 shCoeffs[16];
+};
+
+// Storage of the spherical harmonics, has to match ShStorageMode and ShCompression. 
+// Only the coefficients up to the degree of the scene are stored, as tightly packed RGB triples.
+#define SH_STORAGE_FLOAT32 0
+#define SH_STORAGE_FLOAT16 1
+#define SH_STORAGE_QUANTIZED_8 2
+#define SH_QUANTIZATION_CHUNK_SIZE 256
 
-	// These are modified between GPU passes
-	vec4 color;
-	vec4 covariance;
+// Projected gaussian, written by InitSortList every frame and read by RenderGaussians
+struct GaussianSplatData
+{
+	vec4 conicOpacity; // vec4(inverse 2D covariance xx, xy, yy, alpha)
+	vec2 screenPos;
+	uvec2 color; // uvec2(packHalf2x16(r, g), packHalf2x16(b, 0))
 };
 
-// Data for sorting per gaussian
-struct GaussianSortData
+// Data for sorting per gaussian is split into a key array, (uint64_t(tileIndex) << 32) | depthKey,
+// and a value array of gaussian indices. Has to match GaussianSortList.
+
+// Tile rect and depth key of a gaussian, written by the first pass of the 
+// two-phase InitSortList. Has to match GaussianTileRectData.
+struct GaussianTileRectData
 {
-	uvec4 data; // uvec4(sortKey0, sortKey1, gaussianIndex, 0)
+	uint tileRect; // (minX, minY, maxX, maxY) in 8 bits each, including min, excluding max
+	uint depthKey;
 };
 
 // Data modified by culling algorithms
 struct GaussianCullData
 {
-	uvec4 numGaussiansToRender; // uvec4(num, maxNumSortElements, 0, 0)
+	uvec4 numGaussiansToRender; // uvec4(num, maxNumSortElements, numWithSquareExtents, 0)
+};
+
+// Dispatch size of FindRanges, for the elements InitSortList wrote
+struct FindRangesIndirectSetupData
+{
+	uint sizeX;
+	uint sizeY;
+	uint sizeZ;
+
+	uint numSortElements;
 };
 
 // Tile ranges